@@ -1,5 +1,133 @@
 #include "algorithms.h"
 
+// Helpers shared by the benchmarks and the threaded algorithms:
+
+// Returns the amount of threads to use, 0 selects one per online core.
+static uint32_t algo_threadCount(uint32_t threads) {
+  if (threads == 0) {
+    long cores = sysconf(_SC_NPROCESSORS_ONLN);
+    threads = (cores > 0) ? (uint32_t)cores : 1;
+  }
+  return threads;
+}
+
+// Returns a monotonic timestamp in seconds for the benchmarks.
+static double algo_seconds(void) {
+  struct timespec now;
+  clock_gettime(CLOCK_MONOTONIC, &now);
+  return (double)now.tv_sec + (double)now.tv_nsec * 1e-9;
+}
+
+// Xorshift generator for the benchmark inputs.
+static uint64_t algo_random(uint64_t *state) {
+  uint64_t x = *state;
+  x ^= x << 13;
+  x ^= x >> 7;
+  x ^= x << 17;
+  return *state = x;
+}
+
+// Instrumentation:
+
+#ifdef ALGO_INSTRUMENT
+
+AlgoInstrStats algo_instrStats[ALGO_INSTR_CONTAINERS];
+
+// Scopes that ended at least once, newest first.
+static _Atomic(AlgoInstrScope *) algo_instrScopes = NULL;
+
+uint64_t algo_instrNow(void) {
+  struct timespec now;
+  clock_gettime(CLOCK_MONOTONIC, &now);
+  return (uint64_t)now.tv_sec * 1000000000 + (uint64_t)now.tv_nsec;
+}
+
+void algo_instrScopeEnd(AlgoInstrScope *scope, uint64_t start) {
+  ALGO_INSTR_ADD(scope->nanoseconds, algo_instrNow() - start);
+  ALGO_INSTR_ADD(scope->calls, 1);
+  int expected = 0;
+  if (atomic_load_explicit(&scope->registered, memory_order_relaxed) == 0 &&
+      atomic_compare_exchange_strong(&scope->registered, &expected, 1)) {
+    scope->next = atomic_load(&algo_instrScopes);
+    while (!atomic_compare_exchange_weak(&algo_instrScopes, &scope->next,
+                                         scope)) {
+    }
+  }
+}
+
+#endif
+
+void algo_instrReset(void) {
+#ifdef ALGO_INSTRUMENT
+  for (int i = 0; i < ALGO_INSTR_CONTAINERS; i++) {
+    AlgoInstrStats *stats = &algo_instrStats[i];
+    atomic_store(&stats->allocations, 0);
+    atomic_store(&stats->allocatedBytes, 0);
+    atomic_store(&stats->frees, 0);
+    atomic_store(&stats->resizes, 0);
+    atomic_store(&stats->resizedBytes, 0);
+    atomic_store(&stats->copies, 0);
+    atomic_store(&stats->copiedBytes, 0);
+    atomic_store(&stats->traversals, 0);
+    atomic_store(&stats->traversedNodes, 0);
+    atomic_store(&stats->longestTraversal, 0);
+  }
+  // The scopes stay registered, only their times start over.
+  for (AlgoInstrScope *scope = atomic_load(&algo_instrScopes); scope != NULL;
+       scope = scope->next) {
+    atomic_store(&scope->calls, 0);
+    atomic_store(&scope->nanoseconds, 0);
+  }
+#endif
+}
+
+int algo_instrDump(FILE *out) {
+  if (out == NULL) {
+    return 0;
+  }
+#ifdef ALGO_INSTRUMENT
+  static const char *names[ALGO_INSTR_CONTAINERS] = {"dynarr", "llist",
+                                                     "dllist", "stack"};
+  fprintf(out, "{\n  \"enabled\": true,\n  \"containers\": {");
+  for (int i = 0; i < ALGO_INSTR_CONTAINERS; i++) {
+    AlgoInstrStats *stats = &algo_instrStats[i];
+    fprintf(out,
+            "%s\n    \"%s\": {\"allocations\": %llu, "
+            "\"allocated_bytes\": %llu, \"frees\": %llu, \"resizes\": %llu, "
+            "\"resized_bytes\": %llu, \"copies\": %llu, "
+            "\"copied_bytes\": %llu, \"traversals\": %llu, "
+            "\"traversed_nodes\": %llu, \"longest_traversal\": %llu}",
+            (i == 0) ? "" : ",", names[i],
+            (unsigned long long)atomic_load(&stats->allocations),
+            (unsigned long long)atomic_load(&stats->allocatedBytes),
+            (unsigned long long)atomic_load(&stats->frees),
+            (unsigned long long)atomic_load(&stats->resizes),
+            (unsigned long long)atomic_load(&stats->resizedBytes),
+            (unsigned long long)atomic_load(&stats->copies),
+            (unsigned long long)atomic_load(&stats->copiedBytes),
+            (unsigned long long)atomic_load(&stats->traversals),
+            (unsigned long long)atomic_load(&stats->traversedNodes),
+            (unsigned long long)atomic_load(&stats->longestTraversal));
+  }
+  fprintf(out, "\n  },\n  \"scopes\": [");
+  int first = 1;
+  for (AlgoInstrScope *scope = atomic_load(&algo_instrScopes); scope != NULL;
+       scope = scope->next) {
+    fprintf(out,
+            "%s\n    {\"name\": \"%s\", \"calls\": %llu, "
+            "\"nanoseconds\": %llu}",
+            first ? "" : ",", scope->name,
+            (unsigned long long)atomic_load(&scope->calls),
+            (unsigned long long)atomic_load(&scope->nanoseconds));
+    first = 0;
+  }
+  fprintf(out, "\n  ]\n}\n");
+#else
+  fprintf(out, "{\"enabled\": false}\n");
+#endif
+  return 1;
+}
+
 // Create the dynamic array with the intial data in the argument and an initial
 // size.
 DynamicArray *dynarr_initialize(void *data, size_t dataSize,
@@ -20,6 +148,8 @@ DynamicArray *dynarr_initialize(void *data, size_t dataSize,
     list->data = calloc(initialSize, sizeof(void *));
     list->data[list->highestPosition] = malloc(dataSize);
     memcpy(list->data[0], data, dataSize);
+    ALGO_INSTR_ALLOC(ALGO_INSTR_DYNARR, 2,
+                     sizeof(DynamicArray) + initialSize * sizeof(void *));
     return list;
   }
 }
@@ -50,9 +180,10 @@ int dynarr_add(DynamicArray *list, void *data) {
     fprintf(stderr, "The item can not be added to the list.\n");
     return 0;
   } else {
-    if ((list->size - 1) == list->highestPosition) {
-      // Increase the size of the list.
-      dynarr_resize(list, 1);
+    // Increase the size of the list, a full list that can not grow keeps
+    // its elements and rejects the new one.
+    if ((list->size - 1) == list->highestPosition && !dynarr_resize(list, 1)) {
+      return 0;
     }
     list->data[list->highestPosition + 1] = data;
     list->highestPosition++;
@@ -65,23 +196,22 @@ void *dynarr_remove(DynamicArray *list) {
   if (!(!(list == NULL) && !(list->highestPosition == 0))) {
     return 0;
   } else {
-    if ((ceil((double)(list->size / 2))) < list->highestPosition) {
-      // The list is now smaller than half its size, therefore we need to
-      // descrease the size.
-      dynarr_resize(list, 0);
-    }
     // Acces the data that needs to be removed.
     void *temp = list->data[list->highestPosition];
     // Remove the item from the list.
     list->data[list->highestPosition] = NULL;
     // Update the highest item member.
     list->highestPosition--;
-    return 1;
+    if ((list->highestPosition + 1) < (list->size / 4)) {
+      // The list is now smaller than a quarter of its size, therefore we need
+      // to descrease the size. Shrinking at a quarter instead of a half keeps
+      // alternating adds and removes from resizing every time.
+      dynarr_resize(list, 0);
+    }
+    return temp;
   }
 }
 
-// There is some error in here and i am crying.
-
 // Resize the list and returns the new size.
 // Mode 0: decrease list size, Mode >0: increase list size
 uint64_t dynarr_resize(DynamicArray *list, int mode) {
@@ -91,60 +221,65 @@ uint64_t dynarr_resize(DynamicArray *list, int mode) {
     fprintf(stderr, "The list cant be resized with these parameters!");
     return 0;
   } else {
+    ALGO_INSTR_SCOPE_BEGIN(dynarr_resize);
     // Create the new size of the list.
-    double newSize = 0;
+    uint64_t newSize = 0;
     if (mode) {
       // Increase the list by a power of two.
-      list->data =
-          realloc(list->data, newSize = ceil((double)(list->size * 2)));
-      // Allocate the rest of the new array with null so we dont have to worry
-      // about the garabage values present after realloc, as it is implemented
-      // using malloc and not calloc.
-      for (int i = list->highestPosition + 1; i < newSize; i++) {
-        list->data[i] = NULL;
-      }
-      // If the new size is now smaller than the previous biggest position, we
-      // need to set the new biggest position to be the size of the new array
-      // - 1. (The highest accessible member in the array.)
-      if (newSize <= (list->highestPosition - 1)) {
-        list->highestPosition = newSize - 1;
-      }
+      newSize = list->size ? list->size * 2 : 1;
     } else {
-      // Shrink the list by a factor of two.
-      list->data =
-          realloc(list->data, newSize = ceil((double)(list->size / 2)));
+      // Shrink the list by a factor of two, but keep every stored item.
+      newSize = list->size / 2;
+      if (newSize <= list->highestPosition) {
+        newSize = list->highestPosition + 1;
+      }
+    }
+    // The array holds pointers, the new size has to be counted in bytes.
+    void **data = realloc(list->data, newSize * sizeof(void *));
+    if (data == NULL) {
+      return 0;
+    }
+    list->data = data;
+    // Allocate the rest of the new array with null so we dont have to worry
+    // about the garabage values present after realloc, as it is implemented
+    // using malloc and not calloc.
+    for (uint64_t i = list->size; i < newSize; i++) {
+      list->data[i] = NULL;
     }
     // Set the size member of the list to accurately represent the actual new
     // size.
     list->size = newSize;
-    return 1;
+    // The realloc counts as a new array and the release of the old one.
+    ALGO_INSTR_RESIZE(ALGO_INSTR_DYNARR, newSize * sizeof(void *));
+    ALGO_INSTR_ALLOC(ALGO_INSTR_DYNARR, 1, newSize * sizeof(void *));
+    ALGO_INSTR_FREE(ALGO_INSTR_DYNARR, 1);
+    ALGO_INSTR_SCOPE_END(dynarr_resize);
+    return newSize;
   }
 }
 
 // Removes the item from a specific position in the array.
 void *dynarr_removeAt(DynamicArray *list, uint64_t position) {
-  // Test some basic assertions about the validity of the parameters.
-  if (!(!(list == NULL) && !(list->highestPosition < position))) {
+  // Test some basic assertions about the validity of the parameters. Like
+  // dynarr_remove, the last item of the list is never removed.
+  if (!(!(list == NULL) && !(list->highestPosition == 0) &&
+        !(list->highestPosition < position))) {
     return NULL;
   } else {
-    // Allocate a new temporary variable that gets returned later.
-    void **newList = calloc(list->size, list->dataSize);
     // Save the data before removing it.
     void *temp = list->data[position];
-    if (position != 0) {
-      // The item is not at the start.
-      // Copy the items before the removed one to the new list.
-      memcpy(newList, list->data, list->dataSize * position);
-    }
-    if (position != (list->size - 1)) {
-      // The item is not at the end.
-      // Copy the items after the removed one to the new list.
-      memcpy(newList + position, list->data + position + 1,
-             (list->size - position - 1) * list->dataSize);
-    }
-    list->data = newList;
+    // Close the gap in place by moving the items after the removed one.
+    memmove(list->data + position, list->data + position + 1,
+            (list->highestPosition - position) * sizeof(void *));
+    ALGO_INSTR_COPY(ALGO_INSTR_DYNARR, list->highestPosition - position,
+                    (list->highestPosition - position) * sizeof(void *));
+    list->data[list->highestPosition] = NULL;
     // Decrease the list size members.
     list->highestPosition--;
+    if ((list->highestPosition + 1) < (list->size / 4)) {
+      // Shrink at a quarter of the size, the same as dynarr_remove.
+      dynarr_resize(list, 0);
+    }
     // Return the removed element.
     return temp;
   }
@@ -153,32 +288,20 @@ void *dynarr_removeAt(DynamicArray *list, uint64_t position) {
 int dynarr_addAt(DynamicArray *list, void *data, uint64_t position) {
   if (!(!(list == NULL) && !(list->data == NULL) && !(data == NULL) &&
         !(position > list->highestPosition))) {
-    return 1;
+    return 0;
   } else {
     // Check whether the list is still big enough to contain a new element, and
     // resize if this is not the case.
-    if (list->size == (list->highestPosition - 1)) {
-      dynarr_resize(list, 1);
-    }
-    // Create the new list with the size of the old one.
-    void **newList = calloc(list->size, list->dataSize);
-
-    if (position != 0) {
-      // The item shall be added at the start of the list.
-      // Copy the items from till the position of the item that needs to be
-      // added.
-      memcpy(newList, list->data, list->dataSize * position);
-    }
-    if (position != (list->size - 1)) {
-      // The item shall be added at the end of the list.
-      // Copy the items after the position where the item should be added.
-      memcpy(newList + position + 1, list->data + position,
-             (list->size - position) * list->dataSize);
+    if (list->size == (list->highestPosition + 1) && !dynarr_resize(list, 1)) {
+      return 0;
     }
-    newList[position] = data;
+    // Make room in place by moving the items from the position on.
+    memmove(list->data + position + 1, list->data + position,
+            (list->highestPosition - position + 1) * sizeof(void *));
+    ALGO_INSTR_COPY(ALGO_INSTR_DYNARR, list->highestPosition - position + 1,
+                    (list->highestPosition - position + 1) * sizeof(void *));
     // Add the item to the list.
-    // Update the list struct.
-    list->data = newList;
+    list->data[position] = data;
     list->highestPosition++;
     return 1;
   }
@@ -189,18 +312,321 @@ int dynarr_delete(DynamicArray **list) {
     return 0;
   } else {
     // Delete the data.
-    for (int i = 0; i < (*list)->size; i++) {
-      (*list)->datadeletefuncion((*list)->data[i]);
+    for (uint64_t i = 0; i <= (*list)->highestPosition; i++) {
+      if ((*list)->datadeletefuncion != NULL && (*list)->data[i] != NULL) {
+        (*list)->datadeletefuncion((*list)->data[i]);
+      }
     }
     // Delete the rest of the list.
     free((*list)->data);
-    free((*list)->datadeletefuncion);
     free(*list);
     *list = NULL;
+    ALGO_INSTR_FREE(ALGO_INSTR_DYNARR, 2);
+    return 1;
+  }
+}
+
+// Value storage dynamic array:
+
+// Creates an empty array of elements with dataSize bytes each. The elements
+// are stored in one contiguous buffer which grows by growthFactor, a factor
+// of at most 1 selects VALARR_GROWTH_FACTOR.
+ValueArray *valarr_initialize(size_t dataSize, uint64_t initialCapacity,
+                              double growthFactor) {
+  if (dataSize == 0) {
+    return NULL;
+  } else {
+    ValueArray *array = malloc(sizeof(ValueArray));
+    if (array == NULL) {
+      return NULL;
+    }
+    array->size = 0;
+    array->capacity = 0;
+    array->dataSize = dataSize;
+    array->growthFactor =
+        (growthFactor > 1.0) ? growthFactor : VALARR_GROWTH_FACTOR;
+    array->data = NULL;
+    if (initialCapacity && !valarr_reserve(array, initialCapacity)) {
+      free(array);
+      return NULL;
+    }
+    return array;
+  }
+}
+
+// Returns a pointer to the element at the position, it stays valid until the
+// array is resized.
+void *valarr_at(ValueArray *array, uint64_t position) {
+  if (array == NULL || position >= array->size) {
+    return NULL;
+  } else {
+    return array->data + position * array->dataSize;
+  }
+}
+
+uint64_t valarr_size(ValueArray *array) {
+  return (array == NULL) ? 0 : array->size;
+}
+
+uint64_t valarr_capacity(ValueArray *array) {
+  return (array == NULL) ? 0 : array->capacity;
+}
+
+// Makes sure the array can hold capacity elements without another resize.
+int valarr_reserve(ValueArray *array, uint64_t capacity) {
+  if (array == NULL) {
+    return 0;
+  } else if (capacity <= array->capacity) {
+    return 1;
+  } else {
+    uint8_t *data = realloc(array->data, capacity * array->dataSize);
+    if (data == NULL) {
+      return 0;
+    }
+    array->data = data;
+    array->capacity = capacity;
+    return 1;
+  }
+}
+
+// Grows the capacity geometrically until count more elements fit, which keeps
+// a sequence of adds at amortized O(1).
+static int valarr_grow(ValueArray *array, uint64_t count) {
+  uint64_t needed = array->size + count;
+  if (needed <= array->capacity) {
+    return 1;
+  } else {
+    uint64_t capacity = array->capacity ? array->capacity : 1;
+    while (capacity < needed) {
+      uint64_t grown = (uint64_t)((double)capacity * array->growthFactor);
+      capacity = (grown > capacity) ? grown : capacity + 1;
+    }
+    return valarr_reserve(array, capacity);
+  }
+}
+
+// Releases the capacity that is not used by any element.
+int valarr_shrinkToFit(ValueArray *array) {
+  if (array == NULL) {
+    return 0;
+  } else if (array->size == 0) {
+    free(array->data);
+    array->data = NULL;
+    array->capacity = 0;
+    return 1;
+  } else {
+    uint8_t *data = realloc(array->data, array->size * array->dataSize);
+    if (data == NULL) {
+      return 0;
+    }
+    array->data = data;
+    array->capacity = array->size;
+    return 1;
+  }
+}
+
+// Copies the element to the end of the array.
+int valarr_add(ValueArray *array, const void *data) {
+  return valarr_addN(array, data, 1);
+}
+
+// Copies count contiguous elements to the end of the array with one memcpy.
+int valarr_addN(ValueArray *array, const void *data, uint64_t count) {
+  if (array == NULL || data == NULL || !valarr_grow(array, count)) {
+    return 0;
+  } else {
+    memcpy(array->data + array->size * array->dataSize, data,
+           count * array->dataSize);
+    array->size += count;
+    return 1;
+  }
+}
+
+// Removes the last element and copies it to out, if out is not NULL.
+int valarr_remove(ValueArray *array, void *out) {
+  if (array == NULL || array->size == 0) {
+    return 0;
+  } else {
+    array->size--;
+    if (out != NULL) {
+      memcpy(out, array->data + array->size * array->dataSize,
+             array->dataSize);
+    }
+    return 1;
+  }
+}
+
+// Copies the element to the position, the elements from there on move back by
+// one.
+int valarr_addAt(ValueArray *array, const void *data, uint64_t position) {
+  if (array == NULL || data == NULL || position > array->size ||
+      !valarr_grow(array, 1)) {
+    return 0;
+  } else {
+    uint8_t *slot = array->data + position * array->dataSize;
+    memmove(slot + array->dataSize, slot,
+            (array->size - position) * array->dataSize);
+    memcpy(slot, data, array->dataSize);
+    array->size++;
+    return 1;
+  }
+}
+
+// Removes the element at the position and copies it to out, if out is not
+// NULL. The elements after it move forward by one.
+int valarr_removeAt(ValueArray *array, uint64_t position, void *out) {
+  if (array == NULL || position >= array->size) {
+    return 0;
+  } else {
+    uint8_t *slot = array->data + position * array->dataSize;
+    if (out != NULL) {
+      memcpy(out, slot, array->dataSize);
+    }
+    memmove(slot, slot + array->dataSize,
+            (array->size - position - 1) * array->dataSize);
+    array->size--;
+    return 1;
+  }
+}
+
+// Deletes the array and sets the pointer to NULL.
+int valarr_delete(ValueArray **array) {
+  if (array == NULL || *array == NULL) {
+    return 0;
+  } else {
+    free((*array)->data);
+    free(*array);
+    *array = NULL;
     return 1;
   }
 }
 
+// Prints the time DynamicArray and ValueArray take to append count integers,
+// to sum them up and to insert and remove 1000 of them at the front.
+void valarr_benchmark(uint64_t count) {
+  uint64_t edits = 1000;
+  double times[2][3];
+  int64_t sums[2] = {0, 0};
+  int value = 0;
+
+  // DynamicArray stores a pointer to a separately allocated item.
+  double start = algo_seconds();
+  DynamicArray *list = dynarr_initialize(&value, sizeof(int), 16, NULL);
+  for (uint64_t i = 1; i < count; i++) {
+    int *item = malloc(sizeof(int));
+    *item = (int)i;
+    dynarr_add(list, item);
+  }
+  times[0][0] = algo_seconds() - start;
+  start = algo_seconds();
+  for (uint64_t i = 0; i < count; i++) {
+    sums[0] += *(int *)dynarr_at(list, i);
+  }
+  times[0][1] = algo_seconds() - start;
+  start = algo_seconds();
+  for (uint64_t i = 0; i < edits; i++) {
+    int *item = malloc(sizeof(int));
+    *item = -1;
+    dynarr_addAt(list, item, 0);
+    free(dynarr_removeAt(list, 0));
+  }
+  times[0][2] = algo_seconds() - start;
+  for (uint64_t i = 0; i <= list->highestPosition; i++) {
+    free(list->data[i]);
+  }
+  list->datadeletefuncion = NULL;
+  dynarr_delete(&list);
+
+  start = algo_seconds();
+  ValueArray *array = valarr_initialize(sizeof(int), 16, 0);
+  for (uint64_t i = 0; i < count; i++) {
+    value = (int)i;
+    valarr_add(array, &value);
+  }
+  times[1][0] = algo_seconds() - start;
+  start = algo_seconds();
+  for (uint64_t i = 0; i < count; i++) {
+    sums[1] += *(int *)valarr_at(array, i);
+  }
+  times[1][1] = algo_seconds() - start;
+  start = algo_seconds();
+  for (uint64_t i = 0; i < edits; i++) {
+    value = -1;
+    valarr_addAt(array, &value, 0);
+    valarr_removeAt(array, 0, NULL);
+  }
+  times[1][2] = algo_seconds() - start;
+  valarr_delete(&array);
+
+  printf("%-14s %-12s %-12s %-12s %-6s\n", "array", "append", "sum",
+         "front edits", "check");
+  const char *names[] = {"DynamicArray", "ValueArray"};
+  for (int i = 0; i < 2; i++) {
+    printf("%-14s %-12.5f %-12.5f %-12.5f %-6s\n", names[i], times[i][0],
+           times[i][1], times[i][2], (sums[i] == sums[0]) ? "ok" : "FAIL");
+  }
+}
+
+// Prints the time the generic arrays and the generated Int32Array take to
+// append count integers and to sum them up through their at functions.
+void typedarr_benchmark(uint64_t count) {
+  double times[3][2];
+  int64_t sums[3] = {0, 0, 0};
+  int32_t value = 0;
+
+  double start = algo_seconds();
+  DynamicArray *list = dynarr_initialize(&value, sizeof(int32_t), 16, NULL);
+  for (uint64_t i = 1; i < count; i++) {
+    int32_t *item = malloc(sizeof(int32_t));
+    *item = (int32_t)i;
+    dynarr_add(list, item);
+  }
+  times[0][0] = algo_seconds() - start;
+  start = algo_seconds();
+  for (uint64_t i = 0; i < count; i++) {
+    sums[0] += *(int32_t *)dynarr_at(list, i);
+  }
+  times[0][1] = algo_seconds() - start;
+  for (uint64_t i = 0; i <= list->highestPosition; i++) {
+    free(list->data[i]);
+  }
+  dynarr_delete(&list);
+
+  start = algo_seconds();
+  ValueArray *values = valarr_initialize(sizeof(int32_t), 16, 0);
+  for (uint64_t i = 0; i < count; i++) {
+    value = (int32_t)i;
+    valarr_add(values, &value);
+  }
+  times[1][0] = algo_seconds() - start;
+  start = algo_seconds();
+  for (uint64_t i = 0; i < count; i++) {
+    sums[1] += *(int32_t *)valarr_at(values, i);
+  }
+  times[1][1] = algo_seconds() - start;
+  valarr_delete(&values);
+
+  start = algo_seconds();
+  Int32Array *array = int32arr_initialize(16);
+  for (uint64_t i = 0; i < count; i++) {
+    int32arr_add(array, (int32_t)i);
+  }
+  times[2][0] = algo_seconds() - start;
+  start = algo_seconds();
+  for (uint64_t i = 0; i < int32arr_size(array); i++) {
+    sums[2] += int32arr_get(array, i);
+  }
+  times[2][1] = algo_seconds() - start;
+  int32arr_delete(&array);
+
+  printf("%-14s %-12s %-12s %-6s\n", "array", "append", "sum", "check");
+  const char *names[] = {"DynamicArray", "ValueArray", "Int32Array"};
+  for (int i = 0; i < 3; i++) {
+    printf("%-14s %-12.5f %-12.5f %-6s\n", names[i], times[i][0], times[i][1],
+           (sums[i] == sums[0]) ? "ok" : "FAIL");
+  }
+}
+
 // Prime calculations:
 
 uint8_t *prime_boolarr(int n) {
@@ -222,22 +648,13 @@ int prime_checksoPrimes(uint8_t *primesArray, int n) {
   return amount;
 }
 
+// Returns 1 if n is prime. Uses the deterministic Miller-Rabin test of
+// prime_isPrime64 instead of trial division.
 int prime_prime(int n) {
-  // Checks if the number is valid and does a few efficient checks before
-  // starting to do the rest with stupid, inefficient modulos.
-  if (n < 2 || !((int)n == n) || !(n & 1)) {
+  if (n < 2) {
     return 0;
   } else {
-    if (n == 2) {
-      return 1;
-    }
-    int sqt = floor(sqrt(n));
-    for (int i = 3; i <= sqt; i += 2) {
-      if (!(n % i)) {
-        return 0;
-      }
-    }
-    return 1;
+    return prime_isPrime64((uint64_t)n);
   }
 }
 
@@ -295,508 +712,6925 @@ uint8_t *prime_me_prime(uint32_t n) {
     return primes;
   }
 }
-// Naive way to calculate the prime number under a certain limit specified in
-// the argument. The second argument is a bool specifying if the number should
-// be printed or not. Memory usage: O(n) Time-complexity: O(n log n) (all cases)
-uint64_t *prime_calcPrimeNaive(uint64_t limit) {
-  // Allocate a dynamic array with the size of the limit.
-  uint64_t *primes = (uint64_t *)calloc(limit, sizeof(uint64_t));
-  // Position at which the next prime caclulated will be put in the array.
-  uint64_t position = 1;
-  // Check the case that there is not a single prime in there.
-  if (limit < 2) {
-    return primes;
+// Computes the floor of the square root of n without the rounding errors of
+// the double precision sqrt for large arguments.
+static uint64_t prime_isqrt(uint64_t n) {
+  uint64_t root = (uint64_t)sqrt((double)n);
+  while (root > 0 && (root > UINT32_MAX || root * root > n)) {
+    root--;
   }
-  // As the naive algorithm does not quite work well with 2, we just short
-  // circuit it with a constant time operation.
-  primes[0] = 2;
-  for (uint64_t i = 3; i < limit; i++) {
-    for (uint64_t j = 2; j < limit; j++) {
-      if (!(i % j)) {
-        // I is divisible by j,
-        // therfore by definition not a prime number
-        // and we can continue with the next number.
-        break;
-      } else {
-        if (j == (i - 1)) {
-          // The loop ran and found no number dividing i,
-          // therefore i is prime by definition.
-          // Thus we set the current position in the array equal to i and
-          // increase the position variable afterwards.
-          primes[position++] = i;
-          break;
+  while (root < UINT32_MAX && (root + 1) * (root + 1) <= n) {
+    root++;
+  }
+  return root;
+}
+
+// Returns all odd primes up to and including limit and writes their amount to
+// count. These are the base primes the segmented sieves cross off with.
+static uint32_t *prime_oddPrimesUpTo(uint64_t limit, uint64_t *count) {
+  *count = 0;
+  if (limit < 3) {
+    return calloc(1, sizeof(uint32_t));
+  } else {
+    // Byte i stands for the odd number 2i + 1.
+    uint64_t half = (limit + 1) / 2;
+    uint8_t *composite = calloc(half, sizeof(uint8_t));
+    for (uint64_t i = 1; (2 * i + 1) * (2 * i + 1) <= limit; i++) {
+      if (!composite[i]) {
+        uint64_t p = 2 * i + 1;
+        for (uint64_t j = (p * p) / 2; j < half; j += p) {
+          composite[j] = 1;
         }
       }
     }
+    for (uint64_t i = 1; i < half; i++) {
+      *count += !composite[i];
+    }
+    uint32_t *primes = malloc((*count + 1) * sizeof(uint32_t));
+    uint32_t *itr = primes;
+    for (uint64_t i = 1; i < half; i++) {
+      if (!composite[i]) {
+        *(itr++) = (uint32_t)(2 * i + 1);
+      }
+    }
+    free(composite);
+    return primes;
   }
-  return primes;
 }
 
-// Uses the sieve of atkin algorithm to calculate
-// Only works for limit >= 6.
-uint8_t *prime_satkins(uint64_t limit) {
-  // Create an array of numbers up to limit initially marked as prime.
-  uint8_t *bools = calloc(limit, sizeof(uint8_t));
-  // Computes the floor of the square root of the limit.
-  uint64_t sqt = sqrt(limit);
-  for (uint64_t x = 1; x <= sqt; x++) {
-    for (uint64_t y = 1; y <= sqt; y++) {
-      uint64_t n = (4 * x * x) + (y * y);
-      if (n <= limit &&
-          (n % 60 == 1 || n % 60 == 13 || n % 60 == 17 || n % 60 == 29 ||
-           n % 60 == 37 || n % 60 == 41 || n % 60 == 49 || n % 60 == 53)) {
-        bools[n] = !bools[n];
+// Moves the sieve to the window starting at low. The offsets of the base
+// primes are computed lazily once their square falls into a window.
+static void prime_segmentSeek(PrimeSegmentSieve *sieve, uint64_t low) {
+  sieve->low = low & ~(uint64_t)1;
+  sieve->activeCount = 0;
+}
+
+// Initializes the sieve for the odd numbers in [low, limit).
+static void prime_segmentInit(PrimeSegmentSieve *sieve, uint64_t low,
+                              uint64_t limit) {
+  sieve->limit = limit;
+  sieve->sharedBase = 0;
+  sieve->basePrimes =
+      prime_oddPrimesUpTo(limit ? prime_isqrt(limit - 1) : 0, &sieve->baseCount);
+  sieve->nextOffset = malloc((sieve->baseCount + 1) * sizeof(uint64_t));
+  prime_segmentSeek(sieve, low);
+}
+
+// Initializes the sieve on base primes owned by the caller, they have to cover
+// the square root of every number the sieve is used for.
+static void prime_segmentInitShared(PrimeSegmentSieve *sieve,
+                                    uint32_t *basePrimes, uint64_t baseCount,
+                                    uint64_t low, uint64_t limit) {
+  sieve->limit = limit;
+  sieve->sharedBase = 1;
+  sieve->basePrimes = basePrimes;
+  sieve->baseCount = baseCount;
+  sieve->nextOffset = malloc((baseCount + 1) * sizeof(uint64_t));
+  prime_segmentSeek(sieve, low);
+}
+
+static void prime_segmentFree(PrimeSegmentSieve *sieve) {
+  if (!sieve->sharedBase) {
+    free(sieve->basePrimes);
+  }
+  free(sieve->nextOffset);
+  sieve->basePrimes = NULL;
+  sieve->nextOffset = NULL;
+  sieve->baseCount = 0;
+  sieve->activeCount = 0;
+}
+
+// Sieves the next window into words, which must hold PRIME_SEGMENT_BYTES, and
+// advances the sieve behind it. Returns the amount of valid bits in the
+// window, the bits after them are set, or 0 once limit is reached.
+static uint64_t prime_segmentNext(PrimeSegmentSieve *sieve, uint64_t *words) {
+  uint64_t low = sieve->low;
+  if (low >= sieve->limit) {
+    return 0;
+  } else {
+    uint64_t high = (sieve->limit - low > PRIME_SEGMENT_SPAN)
+                        ? low + PRIME_SEGMENT_SPAN
+                        : sieve->limit;
+    uint64_t bits = (high - low) / 2;
+    memset(words, 0, ((bits + 63) / 64) * sizeof(uint64_t));
+
+    // Activate the base primes whose square is now inside the range.
+    while (sieve->activeCount < sieve->baseCount) {
+      uint64_t p = sieve->basePrimes[sieve->activeCount];
+      uint64_t first = p * p;
+      if (first >= high) {
+        break;
       }
-      n = (3 * x * x) + (y * y);
-      if (n <= limit &&
-          (n % 60 == 7 || n % 60 == 19 || n % 60 == 31 || n % 60 == 43)) {
-        bools[n] = !bools[n];
+      if (first <= low) {
+        // The first odd multiple of p after low.
+        first = (low / p + 1) * p;
+        if (!(first & 1)) {
+          first += p;
+        }
       }
-      n = (3 * x * x) - (y * y);
-      if (x > y && n <= limit &&
-          (n % 60 == 11 || n % 60 == 23 || n % 60 == 47 || n % 60 == 59)) {
-        bools[n] = !bools[n];
+      sieve->nextOffset[sieve->activeCount++] = (first - low - 1) / 2;
+    }
+
+    // Cross off the odd multiples, two consecutive ones are p bits apart.
+    for (uint64_t i = 0; i < sieve->activeCount; i++) {
+      uint64_t p = sieve->basePrimes[i];
+      uint64_t j = sieve->nextOffset[i];
+      for (; j < bits; j += p) {
+        words[j >> 6] |= 1ULL << (j & 63);
       }
+      sieve->nextOffset[i] = j - bits;
+    }
+
+    if (low == 0) {
+      // 1 is not a prime number.
+      words[0] |= 1;
     }
+    if (bits & 63) {
+      words[bits >> 6] |= ~0ULL << (bits & 63);
+    }
+    sieve->low = high;
+    return bits;
   }
+}
 
-  // Sets the composite number to 0, as they are non-prime by definition.
-  for (uint64_t i = 5; i <= sqt; i++) {
-    if (bools[i] == 1) {
-      for (uint64_t j = 1; j * i * i <= limit; j++) {
-        bools[j * i * i] = 0;
+// Spreads the lower 32 bits of x onto the even bit positions.
+static uint64_t prime_spreadBits(uint64_t x) {
+  x &= 0xFFFFFFFFULL;
+  x = (x | (x << 16)) & 0x0000FFFF0000FFFFULL;
+  x = (x | (x << 8)) & 0x00FF00FF00FF00FFULL;
+  x = (x | (x << 4)) & 0x0F0F0F0F0F0F0F0FULL;
+  x = (x | (x << 2)) & 0x3333333333333333ULL;
+  x = (x | (x << 1)) & 0x5555555555555555ULL;
+  return x;
+}
+
+// Writes the window starting at low into a prime_me_prime style bitmap of
+// the given amount of bytes. Every window word covers 128 numbers, which are
+// two words of the bitmap with all even numbers marked.
+static void prime_scatterWindow(uint8_t *primes, uint64_t bytes, uint64_t low,
+                                const uint64_t *words, uint64_t bits) {
+  for (uint64_t q = 0; q < (bits + 63) / 64; q++) {
+    uint64_t byte = low / 8 + q * 16;
+    for (int half = 0; half < 2 && byte < bytes; half++) {
+      uint64_t out = 0x5555555555555555ULL |
+                     (prime_spreadBits(words[q] >> (32 * half)) << 1);
+      for (int b = 0; b < 8 && byte < bytes; b++) {
+        primes[byte++] = (uint8_t)(out >> (8 * b));
       }
     }
   }
+}
 
-  // Return the prime array.
-  return bools;
+// Fixes up the even numbers the odd-only windows do not cover.
+static void prime_finishBitmap(uint8_t *primes, uint32_t n) {
+  if (!(n & 1)) {
+    // The windows end with the last odd number, n itself is even.
+    BIT_SET(primes[n / 8], n % 8);
+  }
+  // 2 is the only even prime.
+  BIT_CLEAR(primes[2 / 8], 2 % 8);
 }
 
-int **gol_generateEmptyField(int width, int height) {
-  int **nextGen = (int **)calloc(width, sizeof(int *));
-  for (int i = 0; i < width; i++) {
-    nextGen[i] = (int *)calloc(height, sizeof(int));
+// Segmented version of prime_me_prime with the same bitmap layout, a set bit
+// marks a composite and can be counted with prime_checkmePrimes. The sieving
+// only ever touches one cache sized window of odd numbers at a time.
+uint8_t *prime_me_primeSegmented(uint32_t n) {
+  uint64_t bytes = (uint64_t)n / 8 + 1;
+  uint8_t *primes = (uint8_t *)calloc(bytes, sizeof(uint8_t));
+  if (primes == NULL || n < 2) {
+    if (primes != NULL && n == 1) {
+      BIT_SET(primes[1 / 8], 1 % 8);
+    }
+    return primes;
+  } else {
+    PrimeSegmentSieve sieve;
+    uint64_t *words = malloc(PRIME_SEGMENT_BYTES);
+    prime_segmentInit(&sieve, 0, (uint64_t)n + 1);
+    uint64_t low = 0;
+    uint64_t bits = 0;
+    while ((bits = prime_segmentNext(&sieve, words))) {
+      prime_scatterWindow(primes, bytes, low, words, bits);
+      low = sieve.low;
+    }
+    prime_finishBitmap(primes, n);
+    prime_segmentFree(&sieve);
+    free(words);
+    return primes;
   }
-  return nextGen;
 }
 
-// Game of life:
+// Returns the number of primes below n, like prime_checkmePrimes does for a
+// bitmap of n bits, while only holding the base primes and a single window in
+// memory.
+uint64_t prime_countSegmented(uint64_t n) {
+  if (n < 3) {
+    return 0;
+  } else {
+    // 2 is not part of the odd-only windows.
+    uint64_t amount = 1;
+    PrimeSegmentSieve sieve;
+    uint64_t *words = malloc(PRIME_SEGMENT_BYTES);
+    prime_segmentInit(&sieve, 0, n);
+    uint64_t bits = 0;
+    while ((bits = prime_segmentNext(&sieve, words))) {
+      for (uint64_t q = 0; q < (bits + 63) / 64; q++) {
+        amount += __builtin_popcountll(~words[q]);
+      }
+    }
+    prime_segmentFree(&sieve);
+    free(words);
+    return amount;
+  }
+}
 
-int **gol_nextGen(int **oldGen, int rows, int cols) {
-  int **nextGen = gol_generateEmptyField(cols, rows);
+// Initializes the iterator for the primes in [start, stop), a stop of 0
+// iterates up to the end of the 64 bit range. Returns 0 if no memory is left.
+int prime_iterInit(PrimeIterator *iter, uint64_t start, uint64_t stop) {
+  if (iter == NULL) {
+    return 0;
+  } else {
+    if (stop == 0) {
+      stop = UINT64_MAX;
+    }
+    iter->words = malloc(PRIME_SEGMENT_BYTES);
+    if (iter->words == NULL) {
+      return 0;
+    }
+    // The base primes are grown by the iterator itself.
+    prime_segmentInitShared(&iter->sieve, NULL, 0, start, stop);
+    iter->baseLimit = 0;
+    iter->windowLow = iter->sieve.low;
+    iter->bits = 0;
+    iter->position = 0;
+    iter->pendingTwo = (start <= 2 && stop > 2);
+    return 1;
+  }
+}
 
-  for (int i = 1; i < rows - 1; i++) {
-    for (int j = 1; j < cols - 1; j++) {
-      int aliveNeighbours = 0;
-      for (int l = -1; l <= 1; l++) {
-        for (int m = -1; m <= 1; m++) {
-          aliveNeighbours += oldGen[i + l][m + j];
-        }
+// Sieves the next window, the base primes are extended first if the window
+// reaches beyond the square of the largest one. Returns 0 at the end.
+static int prime_iterFill(PrimeIterator *iter) {
+  PrimeSegmentSieve *sieve = &iter->sieve;
+  if (sieve->low >= sieve->limit) {
+    return 0;
+  } else {
+    uint64_t high = (sieve->limit - sieve->low > PRIME_SEGMENT_SPAN)
+                        ? sieve->low + PRIME_SEGMENT_SPAN
+                        : sieve->limit;
+    uint64_t needed = prime_isqrt(high - 1);
+    if (needed > iter->baseLimit) {
+      // Doubling the bound keeps the amount of regrowths logarithmic.
+      uint64_t newLimit = iter->baseLimit * 2;
+      uint64_t maxLimit = prime_isqrt(sieve->limit - 1);
+      if (newLimit < needed) {
+        newLimit = needed;
       }
+      if (newLimit > maxLimit) {
+        newLimit = maxLimit;
+      }
+      free(sieve->basePrimes);
+      free(sieve->nextOffset);
+      sieve->basePrimes = prime_oddPrimesUpTo(newLimit, &sieve->baseCount);
+      sieve->nextOffset = malloc((sieve->baseCount + 1) * sizeof(uint64_t));
+      iter->baseLimit = newLimit;
+      // The offsets are recomputed for the new base primes.
+      prime_segmentSeek(sieve, sieve->low);
+    }
+    iter->windowLow = sieve->low;
+    iter->bits = prime_segmentNext(sieve, iter->words);
+    iter->position = 0;
+    return iter->bits != 0;
+  }
+}
 
-      // Apply the rules of the standart CGOL rulesset.
-      aliveNeighbours -= oldGen[i][j];
-      if ((oldGen[i][j]) && (aliveNeighbours < 2)) {
-        nextGen[i][j] = 0;
+// Returns the next prime of the iterator or 0 once stop is reached.
+uint64_t prime_iterNext(PrimeIterator *iter) {
+  if (iter->pendingTwo) {
+    iter->pendingTwo = 0;
+    return 2;
+  }
+  while (1) {
+    while (iter->position < iter->bits) {
+      // The bits after the valid ones are set, no additional check needed.
+      uint64_t word = ~iter->words[iter->position >> 6] &
+                      (~0ULL << (iter->position & 63));
+      if (word) {
+        uint64_t bit = (iter->position & ~63ULL) + __builtin_ctzll(word);
+        iter->position = bit + 1;
+        return iter->windowLow + 2 * bit + 1;
+      }
+      iter->position = (iter->position | 63) + 1;
+    }
+    if (!prime_iterFill(iter)) {
+      return 0;
+    }
+  }
+}
+
+// Moves the iterator so that the next call of prime_iterNext returns the
+// smallest prime not below value. Inside of the current window this is just
+// an index update, otherwise the sieve restarts at value.
+void prime_iterSkipTo(PrimeIterator *iter, uint64_t value) {
+  iter->pendingTwo = (value <= 2 && iter->sieve.limit > 2);
+  if (value >= iter->windowLow && value - iter->windowLow < 2 * iter->bits) {
+    iter->position = (value - iter->windowLow) / 2;
+  } else {
+    prime_segmentSeek(&iter->sieve, value);
+    iter->windowLow = iter->sieve.low;
+    iter->bits = 0;
+    iter->position = 0;
+  }
+}
+
+void prime_iterFree(PrimeIterator *iter) {
+  if (iter != NULL) {
+    free(iter->sieve.basePrimes);
+    prime_segmentFree(&iter->sieve);
+    free(iter->words);
+    iter->words = NULL;
+  }
+}
+
+// Amount of windows one thread of the parallel sieves takes at a time.
+#define PRIME_PARALLEL_CHUNK_WINDOWS 16
+
+// Work shared by the threads of the parallel sieves. The range is cut into
+// chunks of whole windows which the threads take in ascending order, so a
+// thread that is done early simply takes more chunks.
+typedef struct {
+  uint32_t *basePrimes;
+  uint64_t baseCount;
+  uint64_t limit;
+  atomic_uint_fast64_t nextChunk;
+  atomic_uint_fast64_t amount;
+  // Bitmap to merge the windows into, NULL if the primes are only counted.
+  uint8_t *bitmap;
+  uint64_t bytes;
+} PrimeParallelJob;
+
+static void *prime_parallelWorker(void *arg) {
+  PrimeParallelJob *job = (PrimeParallelJob *)arg;
+  uint64_t chunkSize = PRIME_SEGMENT_SPAN * PRIME_PARALLEL_CHUNK_WINDOWS;
+  uint64_t *words = malloc(PRIME_SEGMENT_BYTES);
+  uint64_t amount = 0;
+  PrimeSegmentSieve sieve;
+  prime_segmentInitShared(&sieve, job->basePrimes, job->baseCount, 0, 0);
+
+  while (1) {
+    uint64_t low = atomic_fetch_add(&job->nextChunk, 1) * chunkSize;
+    if (low >= job->limit) {
+      break;
+    }
+    // Each thread only needs its own offsets into the shared base primes.
+    sieve.limit =
+        (job->limit - low > chunkSize) ? low + chunkSize : job->limit;
+    prime_segmentSeek(&sieve, low);
+    uint64_t bits = 0;
+    while ((bits = prime_segmentNext(&sieve, words))) {
+      if (job->bitmap != NULL) {
+        // Chunks are aligned to whole bitmap bytes, no two threads write the
+        // same byte.
+        prime_scatterWindow(job->bitmap, job->bytes, low, words, bits);
       } else {
-        if ((oldGen[i][j]) && (aliveNeighbours > 3)) {
-          nextGen[i][j] = 0;
-        } else {
-          if ((!oldGen[i][j]) && (aliveNeighbours == 3)) {
-            nextGen[i][j] = 1;
-          } else {
-            nextGen[i][j] = oldGen[i][j];
-          }
+        for (uint64_t q = 0; q < (bits + 63) / 64; q++) {
+          amount += __builtin_popcountll(~words[q]);
         }
       }
+      low = sieve.low;
     }
   }
-  // Free the memory and return the new field.
-  free(oldGen);
-  return nextGen;
+  atomic_fetch_add(&job->amount, amount);
+  prime_segmentFree(&sieve);
+  free(words);
+  return NULL;
 }
 
-void gol_nextGeni(int ***oldGen, int rows, int cols) {
-  int **nextGen = gol_generateEmptyField(cols, rows);
+// Runs the job on the given amount of threads, the calling thread is one of
+// them.
+static void prime_runParallel(PrimeParallelJob *job, uint32_t threads) {
+  uint64_t chunkSize = PRIME_SEGMENT_SPAN * PRIME_PARALLEL_CHUNK_WINDOWS;
+  uint64_t chunks = (job->limit + chunkSize - 1) / chunkSize;
+  threads = algo_threadCount(threads);
+  if (threads > chunks) {
+    threads = chunks ? (uint32_t)chunks : 1;
+  }
+  job->basePrimes = prime_oddPrimesUpTo(
+      job->limit ? prime_isqrt(job->limit - 1) : 0, &job->baseCount);
+  atomic_init(&job->nextChunk, 0);
+  atomic_init(&job->amount, 0);
 
-  for (int i = 1; i < rows - 1; i++) {
-    for (int j = 1; j < cols - 1; j++) {
-      int aliveNeighbours = 0;
-      for (int l = -1; l <= 1; l++) {
-        for (int m = -1; m <= 1; m++) {
-          aliveNeighbours += oldGen[0][i + l][m + j];
+  pthread_t *workers = calloc(threads, sizeof(pthread_t));
+  uint32_t started = 0;
+  for (uint32_t i = 1; i < threads; i++) {
+    if (pthread_create(&workers[started], NULL, prime_parallelWorker, job) ==
+        0) {
+      started++;
+    }
+  }
+  // Whatever threads could not be started, the remaining ones take over their
+  // chunks.
+  prime_parallelWorker(job);
+  for (uint32_t i = 0; i < started; i++) {
+    pthread_join(workers[i], NULL);
+  }
+  free(workers);
+  free(job->basePrimes);
+}
+
+// Returns the number of primes below n, the range is sieved by the given
+// amount of threads (0 for one per core) which share the base primes.
+uint64_t prime_countParallel(uint64_t n, uint32_t threads) {
+  if (n < 3) {
+    return 0;
+  } else {
+    PrimeParallelJob job;
+    job.limit = n;
+    job.bitmap = NULL;
+    job.bytes = 0;
+    prime_runParallel(&job, threads);
+    // 2 is not part of the odd-only windows.
+    return atomic_load(&job.amount) + 1;
+  }
+}
+
+// Parallel version of prime_me_primeSegmented, the threads merge their windows
+// into one prime_me_prime style bitmap.
+uint8_t *prime_me_primeParallel(uint32_t n, uint32_t threads) {
+  if (n < 2) {
+    return prime_me_primeSegmented(n);
+  } else {
+    PrimeParallelJob job;
+    job.limit = (uint64_t)n + 1;
+    job.bytes = (uint64_t)n / 8 + 1;
+    job.bitmap = (uint8_t *)calloc(job.bytes, sizeof(uint8_t));
+    if (job.bitmap == NULL) {
+      return NULL;
+    }
+    prime_runParallel(&job, threads);
+    prime_finishBitmap(job.bitmap, n);
+    return job.bitmap;
+  }
+}
+
+// Prints the time prime_countParallel takes for the primes below n with 1, 2,
+// 4, ... up to maxThreads threads (0 for one per core) and the speedup over
+// the single threaded segmented sieve.
+void prime_benchmarkParallel(uint64_t n, uint32_t maxThreads) {
+  maxThreads = algo_threadCount(maxThreads);
+  double start = algo_seconds();
+  uint64_t expected = prime_countSegmented(n);
+  double base = algo_seconds() - start;
+  printf("%-10s %-12s %-12s %-8s\n", "threads", "primes", "seconds",
+         "speedup");
+  printf("%-10s %-12llu %-12.4f %-8.2f\n", "segmented",
+         (unsigned long long)expected, base, 1.0);
+  for (uint32_t threads = 1;; threads *= 2) {
+    if (threads > maxThreads) {
+      threads = maxThreads;
+    }
+    start = algo_seconds();
+    uint64_t amount = prime_countParallel(n, threads);
+    double time = algo_seconds() - start;
+    printf("%-10u %-12llu %-12.4f %-8.2f%s\n", threads,
+           (unsigned long long)amount, time, base / time,
+           (amount == expected) ? "" : " MISMATCH");
+    if (threads == maxThreads) {
+      break;
+    }
+  }
+}
+
+// Odd primes used to filter candidates before the Miller-Rabin rounds, each
+// with its inverse modulo 2^64 and the largest quotient of 2^64 - 1. n is
+// divisible by p exactly if n * inverse <= quotient.
+static const uint64_t prime_smallPrimeFilter[][3] = {
+    {3ULL, 0xAAAAAAAAAAAAAAABULL, 0x5555555555555555ULL},
+    {5ULL, 0xCCCCCCCCCCCCCCCDULL, 0x3333333333333333ULL},
+    {7ULL, 0x6DB6DB6DB6DB6DB7ULL, 0x2492492492492492ULL},
+    {11ULL, 0x2E8BA2E8BA2E8BA3ULL, 0x1745D1745D1745D1ULL},
+    {13ULL, 0x4EC4EC4EC4EC4EC5ULL, 0x13B13B13B13B13B1ULL},
+    {17ULL, 0xF0F0F0F0F0F0F0F1ULL, 0x0F0F0F0F0F0F0F0FULL},
+    {19ULL, 0x86BCA1AF286BCA1BULL, 0x0D79435E50D79435ULL},
+    {23ULL, 0xD37A6F4DE9BD37A7ULL, 0x0B21642C8590B216ULL},
+    {29ULL, 0x34F72C234F72C235ULL, 0x08D3DCB08D3DCB08ULL},
+    {31ULL, 0xEF7BDEF7BDEF7BDFULL, 0x0842108421084210ULL},
+    {37ULL, 0x14C1BACF914C1BADULL, 0x06EB3E45306EB3E4ULL},
+    {41ULL, 0x8F9C18F9C18F9C19ULL, 0x063E7063E7063E70ULL},
+    {43ULL, 0x82FA0BE82FA0BE83ULL, 0x05F417D05F417D05ULL},
+    {47ULL, 0x51B3BEA3677D46CFULL, 0x0572620AE4C415C9ULL},
+    {53ULL, 0x21CFB2B78C13521DULL, 0x04D4873ECADE304DULL},
+};
+
+#define PRIME_FILTER_COUNT                                                     \
+  (sizeof(prime_smallPrimeFilter) / sizeof(prime_smallPrimeFilter[0]))
+
+// Every number below the square of the first prime after the filter that
+// passes it is a prime.
+#define PRIME_FILTER_BOUND (59ULL * 59ULL)
+
+// Bases for which Miller-Rabin is deterministic over all 64 bit numbers.
+static const uint64_t prime_millerRabinBases[] = {
+    2, 325, 9375, 28178, 450775, 9780504, 1795265022};
+
+// Montgomery arithmetic modulo the odd number n with R = 2^64.
+typedef struct {
+  uint64_t n;
+  // n^-1 mod 2^64.
+  uint64_t inverse;
+  // R mod n and R^2 mod n.
+  uint64_t one;
+  uint64_t r2;
+} MontgomeryContext;
+
+static void prime_montgomeryInit(MontgomeryContext *ctx, uint64_t n) {
+  ctx->n = n;
+  // Newton iteration, every step doubles the amount of correct bits.
+  uint64_t inverse = n;
+  for (int i = 0; i < 5; i++) {
+    inverse *= 2 - n * inverse;
+  }
+  ctx->inverse = inverse;
+  ctx->one = (0 - n) % n;
+  // Doubling R mod n 64 times avoids a 128 bit division.
+  uint64_t r2 = ctx->one;
+  for (int i = 0; i < 64; i++) {
+    r2 = (r2 >= n - r2) ? r2 - (n - r2) : r2 + r2;
+  }
+  ctx->r2 = r2;
+}
+
+// Returns t / R mod n for t < n * R.
+static inline uint64_t prime_montgomeryReduce(const MontgomeryContext *ctx,
+                                              unsigned __int128 t) {
+  uint64_t m = (uint64_t)t * ctx->inverse;
+  uint64_t high = (uint64_t)(t >> 64);
+  uint64_t correction = (uint64_t)(((unsigned __int128)m * ctx->n) >> 64);
+  // The low halves of t and m * n are equal, only the high ones are left.
+  return (high < correction) ? high - correction + ctx->n : high - correction;
+}
+
+static inline uint64_t prime_montgomeryMul(const MontgomeryContext *ctx,
+                                           uint64_t a, uint64_t b) {
+  return prime_montgomeryReduce(ctx, (unsigned __int128)a * b);
+}
+
+// Runs one Miller-Rabin round for n - 1 = d * 2^s on the base in Montgomery
+// form, which has to be non-zero modulo n. Returns 1 if n is a probable
+// prime to the base.
+static int prime_millerRabinRound(const MontgomeryContext *ctx, uint64_t d,
+                                  int s, uint64_t base) {
+  uint64_t minusOne = ctx->n - ctx->one;
+  uint64_t x = ctx->one;
+  for (; d; d >>= 1) {
+    if (d & 1) {
+      x = prime_montgomeryMul(ctx, x, base);
+    }
+    base = prime_montgomeryMul(ctx, base, base);
+  }
+  if (x == ctx->one || x == minusOne) {
+    return 1;
+  }
+  for (int i = 1; i < s; i++) {
+    x = prime_montgomeryMul(ctx, x, x);
+    if (x == minusOne) {
+      return 1;
+    }
+  }
+  return 0;
+}
+
+// Checks n against the small primes. Returns 0 or 1 if this decides whether n
+// is prime and -1 if the Miller-Rabin rounds are needed.
+static int prime_smallPrimeCheck(uint64_t n) {
+  if (n < 2) {
+    return 0;
+  } else if (!(n & 1)) {
+    return n == 2;
+  } else {
+    for (size_t i = 0; i < PRIME_FILTER_COUNT; i++) {
+      if (n * prime_smallPrimeFilter[i][1] <= prime_smallPrimeFilter[i][2]) {
+        return n == prime_smallPrimeFilter[i][0];
+      }
+    }
+    return (n < PRIME_FILTER_BOUND) ? 1 : -1;
+  }
+}
+
+// Deterministic primality test for all 64 bit numbers. Small factors are
+// filtered out first, the remaining candidates go through Miller-Rabin with
+// a fixed set of bases in Montgomery arithmetic.
+int prime_isPrime64(uint64_t n) {
+  int small = prime_smallPrimeCheck(n);
+  if (small >= 0) {
+    return small;
+  } else {
+    MontgomeryContext ctx;
+    prime_montgomeryInit(&ctx, n);
+    int s = __builtin_ctzll(n - 1);
+    uint64_t d = (n - 1) >> s;
+    for (size_t i = 0; i < sizeof(prime_millerRabinBases) / sizeof(uint64_t);
+         i++) {
+      uint64_t base = prime_millerRabinBases[i] % n;
+      if (base == 0) {
+        continue;
+      }
+      if (!prime_millerRabinRound(&ctx, d, s,
+                                  prime_montgomeryMul(&ctx, base, ctx.r2))) {
+        return 0;
+      }
+    }
+    return 1;
+  }
+}
+
+// Amount of candidates prime_isPrimeBatch advances in lockstep.
+#define PRIME_BATCH_LANES 4
+
+// State of one lane of prime_isPrimeBatch.
+typedef struct {
+  MontgomeryContext ctx;
+  uint64_t d;
+  int s;
+  // Index of the next base to test, the candidate and its position.
+  size_t base;
+  size_t position;
+  int active;
+} PrimeBatchLane;
+
+// Tests count candidates at once and writes 1 for every prime and 0 for every
+// other number into results, the same answers prime_isPrime64 gives. The
+// candidates that pass the small prime filter are spread over lanes whose
+// modular exponentiations are interleaved, so the independent multiplications
+// overlap in the pipeline instead of waiting on each other. A lane gets the
+// next candidate as soon as its current one is decided.
+void prime_isPrimeBatch(const uint64_t *candidates, uint8_t *results,
+                        size_t count) {
+  if (candidates == NULL || results == NULL) {
+    return;
+  } else {
+    const size_t baseCount =
+        sizeof(prime_millerRabinBases) / sizeof(prime_millerRabinBases[0]);
+    PrimeBatchLane lanes[PRIME_BATCH_LANES];
+    size_t next = 0;
+    int active = 0;
+    for (int l = 0; l < PRIME_BATCH_LANES; l++) {
+      lanes[l].active = 0;
+    }
+    while (1) {
+      // Refill the idle lanes with the next candidates that need the test.
+      for (int l = 0; l < PRIME_BATCH_LANES; l++) {
+        while (!lanes[l].active && next < count) {
+          uint64_t n = candidates[next];
+          int small = prime_smallPrimeCheck(n);
+          if (small >= 0) {
+            results[next++] = (uint8_t)small;
+            continue;
+          }
+          prime_montgomeryInit(&lanes[l].ctx, n);
+          lanes[l].s = __builtin_ctzll(n - 1);
+          lanes[l].d = (n - 1) >> lanes[l].s;
+          lanes[l].base = 0;
+          lanes[l].position = next++;
+          lanes[l].active = 1;
+          active++;
         }
       }
-      // Apply the rules of the standart CGOL rulesset.
-      aliveNeighbours -= oldGen[0][i][j];
-      if ((oldGen[0][i][j]) && (aliveNeighbours < 2)) {
-        nextGen[i][j] = 0;
-      } else {
-        if ((oldGen[0][i][j]) && (aliveNeighbours > 3)) {
-          nextGen[i][j] = 0;
-        } else {
-          if ((!oldGen[0][i][j]) && (aliveNeighbours == 3)) {
-            nextGen[i][j] = 1;
-          } else {
-            nextGen[i][j] = oldGen[0][i][j];
+      if (!active) {
+        break;
+      }
+
+      // Idle lanes are never read, the zeros only show that to the compiler.
+      uint64_t x[PRIME_BATCH_LANES] = {0}, power[PRIME_BATCH_LANES] = {0};
+      int divisible[PRIME_BATCH_LANES] = {0};
+      int bits = 0;
+      for (int l = 0; l < PRIME_BATCH_LANES; l++) {
+        if (lanes[l].active) {
+          const MontgomeryContext *ctx = &lanes[l].ctx;
+          uint64_t a = prime_millerRabinBases[lanes[l].base] % ctx->n;
+          power[l] = prime_montgomeryMul(ctx, a, ctx->r2);
+          divisible[l] = (a == 0);
+          x[l] = ctx->one;
+          int length = 64 - __builtin_clzll(lanes[l].d);
+          bits = (length > bits) ? length : bits;
+        }
+      }
+      // Right to left exponentiation, one bit of every lane per step. The
+      // product is always computed and selected, the exponent bits are random
+      // and a branch on them would be mispredicted half of the time.
+      for (int b = 0; b < bits; b++) {
+        for (int l = 0; l < PRIME_BATCH_LANES; l++) {
+          if (lanes[l].active) {
+            uint64_t product =
+                prime_montgomeryMul(&lanes[l].ctx, x[l], power[l]);
+            x[l] = ((lanes[l].d >> b) & 1) ? product : x[l];
+            power[l] = prime_montgomeryMul(&lanes[l].ctx, power[l], power[l]);
           }
         }
       }
+
+      for (int l = 0; l < PRIME_BATCH_LANES; l++) {
+        if (!lanes[l].active) {
+          continue;
+        }
+        const MontgomeryContext *ctx = &lanes[l].ctx;
+        uint64_t minusOne = ctx->n - ctx->one;
+        // A base divisible by n says nothing about it.
+        int passed = (divisible[l] || x[l] == ctx->one || x[l] == minusOne);
+        for (int r = 1; r < lanes[l].s && !passed; r++) {
+          x[l] = prime_montgomeryMul(ctx, x[l], x[l]);
+          passed = (x[l] == minusOne);
+        }
+        if (!passed || ++lanes[l].base == baseCount) {
+          results[lanes[l].position] = (uint8_t)passed;
+          lanes[l].active = 0;
+          active--;
+        }
+      }
     }
   }
-  // Free the memory and return the new field.
-  free(*(oldGen));
-  *oldGen = nextGen;
 }
 
-void gol_printField(int **field, int width, int height) {
-  for (int i = 0; i < height; i++) {
-    for (int j = 0; j < width; j++) {
-      if (!field[i][j]) {
-        printf(" .");
+// The trial division prime_prime used before, kept as the baseline of the
+// primality benchmark.
+static int prime_trialDivision(uint64_t n) {
+  if (n < 2 || (!(n & 1) && n != 2)) {
+    return n == 2;
+  } else {
+    uint64_t sqt = prime_isqrt(n);
+    for (uint64_t i = 3; i <= sqt; i += 2) {
+      if (!(n % i)) {
+        return 0;
+      }
+    }
+    return 1;
+  }
+}
+
+// Prints the time per candidate of the trial division, prime_isPrime64 and
+// prime_isPrimeBatch on count random odd candidates below 2^31 and of the
+// latter two on count random odd 64 bit candidates.
+void prime_benchmarkPrimality(size_t count) {
+  uint64_t *candidates = malloc(count * sizeof(uint64_t));
+  uint8_t *results = malloc(count);
+  uint64_t state = 0x9E3779B97F4A7C15ULL;
+  printf("%-8s %-14s %-12s %-8s\n", "bits", "method", "ns/number", "primes");
+  for (int bits = 31; bits <= 64; bits += 33) {
+    for (size_t i = 0; i < count; i++) {
+      candidates[i] = (algo_random(&state) >> (64 - bits)) | 1;
+    }
+    for (int method = (bits == 31) ? 0 : 1; method < 3; method++) {
+      size_t primes = 0;
+      double start = algo_seconds();
+      if (method == 2) {
+        prime_isPrimeBatch(candidates, results, count);
       } else {
-        printf(" #");
+        for (size_t i = 0; i < count; i++) {
+          results[i] = (uint8_t)(method ? prime_isPrime64(candidates[i])
+                                        : prime_trialDivision(candidates[i]));
+        }
+      }
+      double time = algo_seconds() - start;
+      for (size_t i = 0; i < count; i++) {
+        primes += results[i];
       }
+      const char *names[] = {"trial", "miller-rabin", "batch"};
+      printf("%-8d %-14s %-12.1f %-8zu\n", bits, names[method],
+             time * 1e9 / (double)count, primes);
     }
-    printf("\n");
   }
+  free(candidates);
+  free(results);
 }
 
-// Does not currently work as well as it should.
-void gol_setField(int **field, int width, int height) {
-  while (1) {
-    printf("BItte geben sie die position ein: ");
-    int row = 0, col = 0, val = 0;
-    scanf("%d.%d %d", &row, &col, &val);
-    if ((col < 0) || (col > width) || (col < 0)) {
-      return;
+// Masks of the Sieve of Atkin indexed by n mod 60. Every block of 60 numbers
+// is a 16 bit word with one bit per residue coprime to 60. Row 0 holds the
+// bits of all residues, rows 1 to 3 only those of the residues handled by
+// the quadratic forms 4x^2 + y^2, 3x^2 + y^2 and 3x^2 - y^2. A toggle with a
+// zero mask does nothing, so no residue has to be tested.
+static const uint16_t prime_atkinMasks[4][60] = {
+    {
+        0x0000, 0x0001, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0002,
+        0x0000, 0x0000, 0x0000, 0x0004, 0x0000, 0x0008, 0x0000, 0x0000,
+        0x0000, 0x0010, 0x0000, 0x0020, 0x0000, 0x0000, 0x0000, 0x0040,
+        0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0080, 0x0000, 0x0100,
+        0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0200, 0x0000, 0x0000,
+        0x0000, 0x0400, 0x0000, 0x0800, 0x0000, 0x0000, 0x0000, 0x1000,
+        0x0000, 0x2000, 0x0000, 0x0000, 0x0000, 0x4000, 0x0000, 0x0000,
+        0x0000, 0x0000, 0x0000, 0x8000,
+    },
+    {
+        0x0000, 0x0001, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000,
+        0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0008, 0x0000, 0x0000,
+        0x0000, 0x0010, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000,
+        0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0080, 0x0000, 0x0000,
+        0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0200, 0x0000, 0x0000,
+        0x0000, 0x0400, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000,
+        0x0000, 0x2000, 0x0000, 0x0000, 0x0000, 0x4000, 0x0000, 0x0000,
+        0x0000, 0x0000, 0x0000, 0x0000,
+    },
+    {
+        0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0002,
+        0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000,
+        0x0000, 0x0000, 0x0000, 0x0020, 0x0000, 0x0000, 0x0000, 0x0000,
+        0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0100,
+        0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000,
+        0x0000, 0x0000, 0x0000, 0x0800, 0x0000, 0x0000, 0x0000, 0x0000,
+        0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000,
+        0x0000, 0x0000, 0x0000, 0x0000,
+    },
+    {
+        0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000,
+        0x0000, 0x0000, 0x0000, 0x0004, 0x0000, 0x0000, 0x0000, 0x0000,
+        0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0040,
+        0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000,
+        0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000,
+        0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x1000,
+        0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000,
+        0x0000, 0x0000, 0x0000, 0x8000,
+    },
+};
+
+// The residues the bits of a block stand for.
+static const uint8_t prime_atkinResidues[16] = {
+    1, 7, 11, 13, 17, 19, 23, 29, 31, 37, 41, 43, 47, 49, 53, 59};
+
+// Amount of 60 number blocks in one window of the Sieve of Atkin. Every x of
+// the forms costs a division per window, so the windows are sized for the L2
+// cache instead of the L1 cache.
+#define PRIME_ATKIN_BLOCKS (PRIME_SEGMENT_BYTES * 4 / sizeof(uint16_t))
+
+// Toggles the solutions n, n + gap, n + 2 gap + 8, ... of a quadratic form for
+// one x, where offset is n minus the start of the window. The position is
+// carried as block and residue, so no division is done per solution. Stops
+// at the end of the window or after maxSteps and returns the steps taken.
+static uint64_t prime_atkinWalk(uint16_t *blocks, uint64_t blockCount,
+                                const uint16_t *mask, uint64_t offset,
+                                uint64_t gap, int64_t gapChange,
+                                uint64_t maxSteps) {
+  uint64_t k = offset / 60, r = offset % 60;
+  int64_t dk = (int64_t)(gap / 60), dr = (int64_t)(gap % 60);
+  uint64_t steps = 0;
+  while (k < blockCount && steps < maxSteps) {
+    blocks[k] ^= mask[r];
+    steps++;
+    k += dk;
+    r += dr;
+    if (r >= 60) {
+      r -= 60;
+      k++;
     }
-    if ((row < 0) || (row > height) || (row < 0)) {
-      return;
+    dr += gapChange;
+    if (dr >= 60) {
+      dr -= 60;
+      dk++;
+    } else if (dr < 0) {
+      dr += 60;
+      dk--;
+    }
+  }
+  return steps;
+}
+
+// Segmented Sieve of Atkin. Returns the number of primes below n. Memory is
+// one window of PRIME_SEGMENT_BYTES plus the base primes and the current y
+// of every x of the three forms, which all grow with sqrt(n).
+uint64_t prime_countAtkin(uint64_t n) {
+  if (n <= 7) {
+    // The forms only produce numbers from 7 on.
+    uint64_t amount = 0;
+    for (uint64_t p = 2; p < n; p++) {
+      amount += (p == 2 || p == 3 || p == 5);
+    }
+    return amount;
+  } else {
+    // The next y to use for every x. The first two forms walk y upwards from
+    // 1 and 2, the third one downwards from x - 1, all in steps of two.
+    uint64_t x1Count = prime_isqrt((n - 1) / 4) + 1;
+    uint64_t x2Count = prime_isqrt((n - 1) / 3) + 1;
+    uint64_t x3Count = prime_isqrt((n - 1) / 2) + 2;
+    uint64_t *y1 = malloc(x1Count * sizeof(uint64_t));
+    uint64_t *y2 = malloc(x2Count * sizeof(uint64_t));
+    uint64_t *y3 = malloc(x3Count * sizeof(uint64_t));
+    for (uint64_t x = 0; x < x1Count; x++) {
+      y1[x] = 1;
+    }
+    for (uint64_t x = 0; x < x2Count; x++) {
+      y2[x] = 2;
+    }
+    for (uint64_t x = 0; x < x3Count; x++) {
+      y3[x] = x ? x - 1 : 0;
+    }
+    uint64_t baseCount = 0;
+    uint32_t *basePrimes = prime_oddPrimesUpTo(prime_isqrt(n - 1), &baseCount);
+    uint16_t *blocks = malloc(PRIME_ATKIN_BLOCKS * sizeof(uint16_t));
+    // 2, 3 and 5 are not coprime to 60.
+    uint64_t amount = 3;
+
+    for (uint64_t low = 0; low < n; low += 60 * PRIME_ATKIN_BLOCKS) {
+      uint64_t blockCount = (n - low + 59) / 60;
+      if (blockCount > PRIME_ATKIN_BLOCKS) {
+        blockCount = PRIME_ATKIN_BLOCKS;
+      }
+      uint64_t high = low + 60 * blockCount;
+      memset(blocks, 0, blockCount * sizeof(uint16_t));
+
+      // 4x^2 + y^2 with odd y, the gap to the next y grows by 8.
+      for (uint64_t x = 1; x < x1Count && 4 * x * x + 1 < high; x++) {
+        uint64_t y = y1[x];
+        uint64_t steps =
+            prime_atkinWalk(blocks, blockCount, prime_atkinMasks[1],
+                            4 * x * x + y * y - low, 4 * y + 4, 8, UINT64_MAX);
+        y1[x] = y + 2 * steps;
+      }
+      // 3x^2 + y^2 with odd x and even y.
+      for (uint64_t x = 1; x < x2Count && 3 * x * x + 4 < high; x += 2) {
+        uint64_t y = y2[x];
+        uint64_t steps =
+            prime_atkinWalk(blocks, blockCount, prime_atkinMasks[2],
+                            3 * x * x + y * y - low, 4 * y + 4, 8, UINT64_MAX);
+        y2[x] = y + 2 * steps;
+      }
+      // 3x^2 - y^2 with x > y and opposite parity, y walks down to 1 or 2 so
+      // n grows and the gap shrinks by 8.
+      for (uint64_t x = 2; x < x3Count && 2 * x * x + 2 * x - 1 < high; x++) {
+        uint64_t y = y3[x];
+        if (y == 0 || y > x) {
+          continue;
+        }
+        uint64_t steps = prime_atkinWalk(
+            blocks, blockCount, prime_atkinMasks[3], 3 * x * x - y * y - low,
+            4 * y - 4, -8, (y + 1) / 2);
+        // A y of 0 or below marks the x as done.
+        y3[x] = (2 * steps >= y) ? 0 : y - 2 * steps;
+      }
+
+      // Remove the multiples of the squares of the primes from 7 on, only the
+      // odd ones can be coprime to 60.
+      for (uint64_t i = 0; i < baseCount; i++) {
+        uint64_t p = basePrimes[i];
+        uint64_t square = p * p;
+        if (p < 7) {
+          continue;
+        }
+        if (square >= high) {
+          break;
+        }
+        uint64_t first =
+            (low <= square) ? square : (low + square - 1) / square * square;
+        if (!(first & 1)) {
+          first += square;
+        }
+        uint64_t k = (first - low) / 60, r = (first - low) % 60;
+        uint64_t dk = (2 * square) / 60, dr = (2 * square) % 60;
+        while (k < blockCount) {
+          blocks[k] &= ~prime_atkinMasks[0][r];
+          k += dk;
+          r += dr;
+          if (r >= 60) {
+            r -= 60;
+            k++;
+          }
+        }
+      }
+
+      // The last window may reach past n.
+      if (high > n) {
+        uint64_t k = (n - low) / 60;
+        for (int b = 0; b < 16; b++) {
+          if (low + 60 * k + prime_atkinResidues[b] >= n) {
+            blocks[k] &= ~(1 << b);
+          }
+        }
+      }
+      for (uint64_t k = 0; k < blockCount; k++) {
+        amount += __builtin_popcount(blocks[k]);
+      }
+    }
+    free(y1);
+    free(y2);
+    free(y3);
+    free(basePrimes);
+    free(blocks);
+    return amount;
+  }
+}
+
+// Prints the time the Eratosthenes variants and the Sieve of Atkin take to
+// count the primes below 10^3, 10^4, ... up to maxN, so the faster engine
+// can be picked per range. prime_me_prime is only run while its bitmap is
+// reasonably small.
+void prime_benchmarkEngines(uint64_t maxN) {
+  printf("%-14s %-12s %-12s %-12s %-12s %-10s\n", "n", "primes",
+         "me_prime", "segmented", "atkin", "fastest");
+  for (uint64_t n = 1000; n <= maxN; n *= 10) {
+    double times[3] = {-1.0, 0.0, 0.0};
+    uint64_t counts[3] = {0, 0, 0};
+    double start = 0;
+    if (n <= (1ULL << 31)) {
+      start = algo_seconds();
+      uint8_t *bitmap = prime_me_prime((uint32_t)n);
+      counts[0] = (uint64_t)prime_checkmePrimes(bitmap, (int)n);
+      times[0] = algo_seconds() - start;
+      free(bitmap);
+    }
+    start = algo_seconds();
+    counts[1] = prime_countSegmented(n);
+    times[1] = algo_seconds() - start;
+    start = algo_seconds();
+    counts[2] = prime_countAtkin(n);
+    times[2] = algo_seconds() - start;
+
+    const char *names[] = {"me_prime", "segmented", "atkin"};
+    int fastest = 1;
+    for (int i = 0; i < 3; i++) {
+      if (times[i] >= 0 && times[i] < times[fastest]) {
+        fastest = i;
+      }
+    }
+    printf("%-14llu %-12llu ", (unsigned long long)n,
+           (unsigned long long)counts[1]);
+    if (times[0] >= 0) {
+      printf("%-12.5f ", times[0]);
+    } else {
+      printf("%-12s ", "-");
+    }
+    printf("%-12.5f %-12.5f %-10s%s\n", times[1], times[2], names[fastest],
+           (counts[2] == counts[1]) ? "" : " MISMATCH");
+  }
+}
+
+// Naive way to calculate the prime number under a certain limit specified in
+// the argument. The second argument is a bool specifying if the number should
+// be printed or not. Memory usage: O(n) Time-complexity: O(n log n) (all cases)
+uint64_t *prime_calcPrimeNaive(uint64_t limit) {
+  // Allocate a dynamic array with the size of the limit.
+  uint64_t *primes = (uint64_t *)calloc(limit, sizeof(uint64_t));
+  // Position at which the next prime caclulated will be put in the array.
+  uint64_t position = 1;
+  // Check the case that there is not a single prime in there.
+  if (limit < 2) {
+    return primes;
+  }
+  // As the naive algorithm does not quite work well with 2, we just short
+  // circuit it with a constant time operation.
+  primes[0] = 2;
+  for (uint64_t i = 3; i < limit; i++) {
+    for (uint64_t j = 2; j < limit; j++) {
+      if (!(i % j)) {
+        // I is divisible by j,
+        // therfore by definition not a prime number
+        // and we can continue with the next number.
+        break;
+      } else {
+        if (j == (i - 1)) {
+          // The loop ran and found no number dividing i,
+          // therefore i is prime by definition.
+          // Thus we set the current position in the array equal to i and
+          // increase the position variable afterwards.
+          primes[position++] = i;
+          break;
+        }
+      }
+    }
+  }
+  return primes;
+}
+
+// Uses the sieve of atkin algorithm to calculate
+// Only works for limit >= 6.
+uint8_t *prime_satkins(uint64_t limit) {
+  // Create an array of the numbers 0 to limit, the loops below mark limit
+  // itself too.
+  uint8_t *bools = calloc(limit + 1, sizeof(uint8_t));
+  if (bools == NULL) {
+    return NULL;
+  }
+  // Computes the floor of the square root of the limit.
+  uint64_t sqt = sqrt(limit);
+  for (uint64_t x = 1; x <= sqt; x++) {
+    for (uint64_t y = 1; y <= sqt; y++) {
+      uint64_t n = (4 * x * x) + (y * y);
+      if (n <= limit &&
+          (n % 60 == 1 || n % 60 == 13 || n % 60 == 17 || n % 60 == 29 ||
+           n % 60 == 37 || n % 60 == 41 || n % 60 == 49 || n % 60 == 53)) {
+        bools[n] = !bools[n];
+      }
+      n = (3 * x * x) + (y * y);
+      if (n <= limit &&
+          (n % 60 == 7 || n % 60 == 19 || n % 60 == 31 || n % 60 == 43)) {
+        bools[n] = !bools[n];
+      }
+      n = (3 * x * x) - (y * y);
+      if (x > y && n <= limit &&
+          (n % 60 == 11 || n % 60 == 23 || n % 60 == 47 || n % 60 == 59)) {
+        bools[n] = !bools[n];
+      }
+    }
+  }
+
+  // Sets the composite number to 0, as they are non-prime by definition.
+  for (uint64_t i = 5; i <= sqt; i++) {
+    if (bools[i] == 1) {
+      for (uint64_t j = 1; j * i * i <= limit; j++) {
+        bools[j * i * i] = 0;
+      }
+    }
+  }
+
+  // Return the prime array.
+  return bools;
+}
+
+// Allocates a field of height rows with width cells each, indexed as
+// field[row][col] like in gol_nextGen and gol_printField.
+int **gol_generateEmptyField(int width, int height) {
+  int **nextGen = (int **)calloc(height, sizeof(int *));
+  for (int i = 0; i < height; i++) {
+    nextGen[i] = (int *)calloc(width, sizeof(int));
+  }
+  return nextGen;
+}
+
+// Game of life:
+
+int **gol_nextGen(int **oldGen, int rows, int cols) {
+  int **nextGen = gol_generateEmptyField(cols, rows);
+
+  for (int i = 1; i < rows - 1; i++) {
+    for (int j = 1; j < cols - 1; j++) {
+      int aliveNeighbours = 0;
+      for (int l = -1; l <= 1; l++) {
+        for (int m = -1; m <= 1; m++) {
+          aliveNeighbours += oldGen[i + l][m + j];
+        }
+      }
+
+      // Apply the rules of the standart CGOL rulesset.
+      aliveNeighbours -= oldGen[i][j];
+      if ((oldGen[i][j]) && (aliveNeighbours < 2)) {
+        nextGen[i][j] = 0;
+      } else {
+        if ((oldGen[i][j]) && (aliveNeighbours > 3)) {
+          nextGen[i][j] = 0;
+        } else {
+          if ((!oldGen[i][j]) && (aliveNeighbours == 3)) {
+            nextGen[i][j] = 1;
+          } else {
+            nextGen[i][j] = oldGen[i][j];
+          }
+        }
+      }
+    }
+  }
+  // Free the memory and return the new field.
+  for (int i = 0; i < rows; i++) {
+    free(oldGen[i]);
+  }
+  free(oldGen);
+  return nextGen;
+}
+
+void gol_nextGeni(int ***oldGen, int rows, int cols) {
+  int **nextGen = gol_generateEmptyField(cols, rows);
+
+  for (int i = 1; i < rows - 1; i++) {
+    for (int j = 1; j < cols - 1; j++) {
+      int aliveNeighbours = 0;
+      for (int l = -1; l <= 1; l++) {
+        for (int m = -1; m <= 1; m++) {
+          aliveNeighbours += oldGen[0][i + l][m + j];
+        }
+      }
+      // Apply the rules of the standart CGOL rulesset.
+      aliveNeighbours -= oldGen[0][i][j];
+      if ((oldGen[0][i][j]) && (aliveNeighbours < 2)) {
+        nextGen[i][j] = 0;
+      } else {
+        if ((oldGen[0][i][j]) && (aliveNeighbours > 3)) {
+          nextGen[i][j] = 0;
+        } else {
+          if ((!oldGen[0][i][j]) && (aliveNeighbours == 3)) {
+            nextGen[i][j] = 1;
+          } else {
+            nextGen[i][j] = oldGen[0][i][j];
+          }
+        }
+      }
+    }
+  }
+  // Free the memory and return the new field.
+  for (int i = 0; i < rows; i++) {
+    free(oldGen[0][i]);
+  }
+  free(*(oldGen));
+  *oldGen = nextGen;
+}
+
+// Applies the rules of the standard CGOL ruleset to 64 cells at once. The
+// arguments are the west, centre and east neighbours of the row above, the
+// row itself and the row below, so bit j of every argument belongs to the
+// same cell. The eight neighbours are summed bitwise with full adders, only
+// the bits of weight 1, 2 and 4 are kept as 8 neighbours kill a cell anyway.
+static inline uint64_t gol_lifeRule(uint64_t aw, uint64_t a, uint64_t ae,
+                                    uint64_t bw, uint64_t b, uint64_t be,
+                                    uint64_t cw, uint64_t c, uint64_t ce) {
+  uint64_t s1 = aw ^ a ^ ae, c1 = (aw & a) | (ae & (aw ^ a));
+  uint64_t s2 = bw ^ be ^ cw, c2 = (bw & be) | (cw & (bw ^ be));
+  uint64_t s3 = c ^ ce, c3 = c & ce;
+  uint64_t ones = s1 ^ s2 ^ s3, c4 = (s1 & s2) | (s3 & (s1 ^ s2));
+  uint64_t t = c1 ^ c2 ^ c3, c5 = (c1 & c2) | (c3 & (c1 ^ c2));
+  uint64_t twos = t ^ c4, fours = c5 ^ (t & c4);
+  // Alive with 3 neighbours or with 2 neighbours and alive before.
+  return twos & ~fours & (ones | b);
+}
+
+#ifdef __AVX2__
+// AVX2 version of gol_lifeRule for four words at once.
+static inline __m256i gol_lifeRule256(__m256i aw, __m256i a, __m256i ae,
+                                      __m256i bw, __m256i b, __m256i be,
+                                      __m256i cw, __m256i c, __m256i ce) {
+  __m256i s1 = _mm256_xor_si256(_mm256_xor_si256(aw, a), ae);
+  __m256i c1 = _mm256_or_si256(_mm256_and_si256(aw, a),
+                               _mm256_and_si256(ae, _mm256_xor_si256(aw, a)));
+  __m256i s2 = _mm256_xor_si256(_mm256_xor_si256(bw, be), cw);
+  __m256i c2 = _mm256_or_si256(_mm256_and_si256(bw, be),
+                               _mm256_and_si256(cw, _mm256_xor_si256(bw, be)));
+  __m256i s3 = _mm256_xor_si256(c, ce), c3 = _mm256_and_si256(c, ce);
+  __m256i ones = _mm256_xor_si256(_mm256_xor_si256(s1, s2), s3);
+  __m256i c4 = _mm256_or_si256(_mm256_and_si256(s1, s2),
+                               _mm256_and_si256(s3, _mm256_xor_si256(s1, s2)));
+  __m256i t = _mm256_xor_si256(_mm256_xor_si256(c1, c2), c3);
+  __m256i c5 = _mm256_or_si256(_mm256_and_si256(c1, c2),
+                               _mm256_and_si256(c3, _mm256_xor_si256(c1, c2)));
+  __m256i twos = _mm256_xor_si256(t, c4);
+  __m256i fours = _mm256_xor_si256(c5, _mm256_and_si256(t, c4));
+  return _mm256_andnot_si256(fours,
+                             _mm256_and_si256(twos, _mm256_or_si256(ones, b)));
+}
+#endif
+
+// Computes word w of a row from the rows above and below. The padding words
+// make w - 1 and w + 1 valid for every used word.
+static inline uint64_t gol_stepWord(const uint64_t *above, const uint64_t *row,
+                                    const uint64_t *below, size_t w) {
+  return gol_lifeRule(
+      (above[w] << 1) | (above[w - 1] >> 63), above[w],
+      (above[w] >> 1) | (above[w + 1] << 63),
+      (row[w] << 1) | (row[w - 1] >> 63), row[w],
+      (row[w] >> 1) | (row[w + 1] << 63),
+      (below[w] << 1) | (below[w - 1] >> 63), below[w],
+      (below[w] >> 1) | (below[w + 1] << 63));
+}
+
+// Computes the rows [firstRow, lastRow) of the next generation of src into
+// dst. The outer rows and columns are dead in every generation, just like in
+// gol_nextGen.
+static void gol_bitboardStepRows(const GolBitboard *board, const uint64_t *src,
+                                 uint64_t *dst, int firstRow, int lastRow) {
+  size_t stride = board->stride;
+  for (int r = firstRow; r < lastRow; r++) {
+    uint64_t *out = dst + (size_t)r * stride;
+    if (r == 0 || r == board->rows - 1) {
+      memset(out, 0, stride * sizeof(uint64_t));
+      continue;
+    }
+    const uint64_t *above = src + (size_t)(r - 1) * stride;
+    const uint64_t *row = above + stride;
+    const uint64_t *below = row + stride;
+    size_t w = 1;
+#ifdef __AVX2__
+    for (; w + 4 <= stride - 1; w += 4) {
+#define GOL_LOAD(p, o) _mm256_loadu_si256((const __m256i *)((p) + w + (o)))
+#define GOL_WEST(p)                                                            \
+  _mm256_or_si256(_mm256_slli_epi64(GOL_LOAD(p, 0), 1),                       \
+                  _mm256_srli_epi64(GOL_LOAD(p, -1), 63))
+#define GOL_EAST(p)                                                            \
+  _mm256_or_si256(_mm256_srli_epi64(GOL_LOAD(p, 0), 1),                       \
+                  _mm256_slli_epi64(GOL_LOAD(p, 1), 63))
+      __m256i next = gol_lifeRule256(
+          GOL_WEST(above), GOL_LOAD(above, 0), GOL_EAST(above), GOL_WEST(row),
+          GOL_LOAD(row, 0), GOL_EAST(row), GOL_WEST(below), GOL_LOAD(below, 0),
+          GOL_EAST(below));
+      _mm256_storeu_si256(
+          (__m256i *)(out + w),
+          _mm256_and_si256(next, GOL_LOAD(board->interiorMask, 0)));
+#undef GOL_LOAD
+#undef GOL_WEST
+#undef GOL_EAST
+    }
+#endif
+    for (; w < stride - 1; w++) {
+      out[w] = gol_stepWord(above, row, below, w) & board->interiorMask[w];
+    }
+  }
+}
+
+// Marks the tile and its eight neighbours as active for the next generation.
+static void gol_bitboardActivate(GolBitboard *board, uint8_t *active,
+                                 size_t tileRow, size_t tileCol) {
+  size_t firstRow = tileRow ? tileRow - 1 : 0;
+  size_t firstCol = tileCol ? tileCol - 1 : 0;
+  for (size_t r = firstRow; r <= tileRow + 1 && r < board->tileRowCount; r++) {
+    for (size_t c = firstCol; c <= tileCol + 1 && c < board->tileColCount;
+         c++) {
+      active[r * board->tileColCount + c] = 1;
+    }
+  }
+}
+
+// Steps only the active tiles. A tile that is not active did not change in
+// the last generation and neither did its neighbours, so it does not change
+// now and both buffers already hold the same words for it.
+static void gol_bitboardStepTiles(GolBitboard *board) {
+  size_t stride = board->stride;
+  size_t tileCount = board->tileRowCount * board->tileColCount;
+  memset(board->nextActive, 0, tileCount);
+  board->tilesTouched = 0;
+  board->tilesChanged = 0;
+  for (size_t t = 0; t < tileCount; t++) {
+    if (!board->activeTiles[t]) {
+      continue;
+    }
+    size_t tileRow = t / board->tileColCount, tileCol = t % board->tileColCount;
+    size_t w = tileCol + 1;
+    int first = (int)(tileRow * GOL_TILE_ROWS);
+    int last = (first + GOL_TILE_ROWS < board->rows) ? first + GOL_TILE_ROWS
+                                                     : board->rows;
+    uint64_t changed = 0;
+    for (int r = first; r < last; r++) {
+      const uint64_t *row = board->cells + (size_t)r * stride;
+      uint64_t word = 0;
+      if (r != 0 && r != board->rows - 1) {
+        word = gol_stepWord(row - stride, row, row + stride, w) &
+               board->interiorMask[w];
+      }
+      board->next[(size_t)r * stride + w] = word;
+      changed |= word ^ row[w];
+    }
+    board->tilesTouched++;
+    if (changed) {
+      board->tilesChanged++;
+      gol_bitboardActivate(board, board->nextActive, tileRow, tileCol);
+    }
+  }
+  uint8_t *temp = board->activeTiles;
+  board->activeTiles = board->nextActive;
+  board->nextActive = temp;
+  board->totalTilesTouched += board->tilesTouched;
+  board->trackedGenerations++;
+}
+
+// Enables the incremental mode of gol_bitboardStep, which only recomputes the
+// tiles of 64 columns and GOL_TILE_ROWS rows that changed in the last
+// generation and their neighbours. The threaded gol_run always steps the
+// whole field and does not keep the tiles up to date.
+int gol_bitboardEnableTracking(GolBitboard *board) {
+  if (board == NULL) {
+    return 0;
+  } else if (board->activeTiles != NULL) {
+    return 1;
+  } else {
+    board->tileRowCount = (size_t)(board->rows + GOL_TILE_ROWS - 1) /
+                          GOL_TILE_ROWS;
+    board->tileColCount = board->stride - 2;
+    size_t tileCount = board->tileRowCount * board->tileColCount;
+    board->activeTiles = malloc(tileCount);
+    board->nextActive = malloc(tileCount);
+    if (board->activeTiles == NULL || board->nextActive == NULL) {
+      gol_bitboardDisableTracking(board);
+      return 0;
+    }
+    // Start with every tile active and equal buffers.
+    memset(board->activeTiles, 1, tileCount);
+    memcpy(board->next, board->cells,
+           (size_t)board->rows * board->stride * sizeof(uint64_t));
+    board->tilesTouched = 0;
+    board->tilesChanged = 0;
+    board->totalTilesTouched = 0;
+    board->trackedGenerations = 0;
+    return 1;
+  }
+}
+
+void gol_bitboardDisableTracking(GolBitboard *board) {
+  if (board != NULL) {
+    free(board->activeTiles);
+    free(board->nextActive);
+    board->activeTiles = NULL;
+    board->nextActive = NULL;
+  }
+}
+
+// Returns the tile counters of the incremental mode: the tiles of the field,
+// those recomputed and changed in the last generation and the average amount
+// recomputed per generation.
+GolTileStats gol_bitboardTileStats(GolBitboard *board) {
+  GolTileStats stats = {0, 0, 0, 0.0};
+  if (board != NULL && board->activeTiles != NULL) {
+    stats.tiles = board->tileRowCount * board->tileColCount;
+    stats.touched = board->tilesTouched;
+    stats.changed = board->tilesChanged;
+    if (board->trackedGenerations) {
+      stats.averageTouched = (double)board->totalTilesTouched /
+                             (double)board->trackedGenerations;
+    }
+  }
+  return stats;
+}
+
+// Creates an empty bitboard with rows * cols cells.
+GolBitboard *gol_bitboardCreate(int rows, int cols) {
+  if (rows <= 0 || cols <= 0) {
+    return NULL;
+  } else {
+    GolBitboard *board = malloc(sizeof(GolBitboard));
+    board->rows = rows;
+    board->cols = cols;
+    board->stride = (size_t)(cols + 63) / 64 + 2;
+    board->cells = calloc((size_t)rows * board->stride, sizeof(uint64_t));
+    board->next = calloc((size_t)rows * board->stride, sizeof(uint64_t));
+    board->interiorMask = calloc(board->stride, sizeof(uint64_t));
+    board->activeTiles = NULL;
+    board->nextActive = NULL;
+    // Column c is bit c % 64 of word c / 64 + 1, the first and the last column
+    // are left out.
+    for (int c = 1; c < cols - 1; c++) {
+      BIT_SET(board->interiorMask[c / 64 + 1], c % 64);
+    }
+    return board;
+  }
+}
+
+// Creates a bitboard from a field in the layout of gol_generateEmptyField.
+GolBitboard *gol_bitboardFromField(int **field, int rows, int cols) {
+  if (field == NULL) {
+    return NULL;
+  } else {
+    GolBitboard *board = gol_bitboardCreate(rows, cols);
+    for (int i = 0; board != NULL && i < rows; i++) {
+      for (int j = 0; j < cols; j++) {
+        gol_bitboardSet(board, i, j, field[i][j]);
+      }
+    }
+    return board;
+  }
+}
+
+// Writes the bitboard into a field in the layout of gol_generateEmptyField.
+void gol_bitboardCopyToField(GolBitboard *board, int **field) {
+  if (board == NULL || field == NULL) {
+    return;
+  } else {
+    for (int i = 0; i < board->rows; i++) {
+      for (int j = 0; j < board->cols; j++) {
+        field[i][j] = gol_bitboardGet(board, i, j);
+      }
+    }
+  }
+}
+
+// Returns a new field in the layout of gol_generateEmptyField.
+int **gol_bitboardToField(GolBitboard *board) {
+  if (board == NULL) {
+    return NULL;
+  } else {
+    int **field = gol_generateEmptyField(board->cols, board->rows);
+    gol_bitboardCopyToField(board, field);
+    return field;
+  }
+}
+
+int gol_bitboardGet(GolBitboard *board, int row, int col) {
+  if (board == NULL || row < 0 || row >= board->rows || col < 0 ||
+      col >= board->cols) {
+    return 0;
+  } else {
+    return (int)BIT_CHECK(
+        board->cells[(size_t)row * board->stride + col / 64 + 1], col % 64);
+  }
+}
+
+void gol_bitboardSet(GolBitboard *board, int row, int col, int alive) {
+  if (board == NULL || row < 0 || row >= board->rows || col < 0 ||
+      col >= board->cols) {
+    return;
+  } else {
+    uint64_t *word = &board->cells[(size_t)row * board->stride + col / 64 + 1];
+    if (alive) {
+      BIT_SET(*word, col % 64);
+    } else {
+      BIT_CLEAR(*word, col % 64);
+    }
+    if (board->activeTiles != NULL) {
+      gol_bitboardActivate(board, board->activeTiles,
+                           (size_t)row / GOL_TILE_ROWS, (size_t)col / 64);
+    }
+  }
+}
+
+// Advances the bitboard by one generation, the buffers are swapped instead of
+// allocating a new field. With tracking enabled only the active tiles are
+// recomputed.
+void gol_bitboardStep(GolBitboard *board) {
+  if (board == NULL) {
+    return;
+  } else {
+    if (board->activeTiles != NULL) {
+      gol_bitboardStepTiles(board);
+    } else {
+      gol_bitboardStepRows(board, board->cells, board->next, 0, board->rows);
+    }
+    uint64_t *temp = board->cells;
+    board->cells = board->next;
+    board->next = temp;
+  }
+}
+
+// Returns the amount of living cells.
+uint64_t gol_bitboardPopulation(GolBitboard *board) {
+  uint64_t population = 0;
+  if (board != NULL) {
+    for (size_t i = 0; i < (size_t)board->rows * board->stride; i++) {
+      population += __builtin_popcountll(board->cells[i]);
+    }
+  }
+  return population;
+}
+
+void gol_bitboardDelete(GolBitboard *board) {
+  if (board != NULL) {
+    free(board->cells);
+    free(board->next);
+    free(board->interiorMask);
+    gol_bitboardDisableTracking(board);
+    free(board);
+  }
+}
+
+// Steps the band of rows of one thread through the generations of the
+// current job. The threads wait for each other after every generation, as
+// the next one reads the rows of the neighbouring bands.
+static void gol_simulationBand(GolSimulation *sim, uint32_t index,
+                               uint64_t generations) {
+  GolBitboard *board = sim->board;
+  int first = (int)((int64_t)board->rows * index / sim->threads);
+  int last = (int)((int64_t)board->rows * (index + 1) / sim->threads);
+  uint64_t *src = board->cells;
+  uint64_t *dst = board->next;
+  for (uint64_t g = 0; g < generations; g++) {
+    gol_bitboardStepRows(board, src, dst, first, last);
+    if (sim->threads > 1) {
+      pthread_barrier_wait(&sim->barrier);
+    }
+    uint64_t *temp = src;
+    src = dst;
+    dst = temp;
+  }
+}
+
+static void *gol_simulationWorker(void *arg) {
+  GolSimulation *sim = (GolSimulation *)arg;
+  pthread_mutex_lock(&sim->lock);
+  uint32_t index = sim->started++;
+  uint64_t seenJob = 0;
+  while (1) {
+    while (sim->jobId == seenJob && !sim->shutdown) {
+      pthread_cond_wait(&sim->wake, &sim->lock);
+    }
+    if (sim->shutdown) {
+      break;
+    }
+    seenJob = sim->jobId;
+    uint64_t generations = sim->jobGenerations;
+    pthread_mutex_unlock(&sim->lock);
+    gol_simulationBand(sim, index, generations);
+    pthread_mutex_lock(&sim->lock);
+  }
+  pthread_mutex_unlock(&sim->lock);
+  return NULL;
+}
+
+// Creates a simulation of an empty rows * cols field, stepped by the given
+// amount of threads (0 for one per core). The worker threads and both
+// buffers are created once and reused by every gol_run.
+GolSimulation *gol_simulationCreate(int rows, int cols, uint32_t threads) {
+  GolBitboard *board = gol_bitboardCreate(rows, cols);
+  if (board == NULL) {
+    return NULL;
+  } else {
+    GolSimulation *sim = malloc(sizeof(GolSimulation));
+    sim->board = board;
+    sim->generation = 0;
+    threads = algo_threadCount(threads);
+    // Every thread gets at least one row.
+    sim->threads = (threads > (uint32_t)rows) ? (uint32_t)rows : threads;
+    sim->jobId = 0;
+    sim->jobGenerations = 0;
+    sim->shutdown = 0;
+    // The calling thread of gol_run steps the first band itself.
+    sim->started = 1;
+    pthread_mutex_init(&sim->lock, NULL);
+    pthread_cond_init(&sim->wake, NULL);
+    pthread_barrier_init(&sim->barrier, NULL, sim->threads);
+    sim->workers = calloc(sim->threads, sizeof(pthread_t));
+    for (uint32_t i = 1; i < sim->threads; i++) {
+      if (pthread_create(&sim->workers[i], NULL, gol_simulationWorker, sim)) {
+        // Without all of its threads the barrier would never open.
+        fprintf(stderr, "The simulation threads could not be started!\n");
+        sim->threads = i;
+        gol_simulationDelete(sim);
+        return NULL;
+      }
+    }
+    return sim;
+  }
+}
+
+// Creates a simulation from a field in the layout of gol_generateEmptyField.
+GolSimulation *gol_simulationFromField(int **field, int rows, int cols,
+                                       uint32_t threads) {
+  GolSimulation *sim = gol_simulationCreate(rows, cols, threads);
+  if (sim != NULL && field != NULL) {
+    for (int i = 0; i < rows; i++) {
+      for (int j = 0; j < cols; j++) {
+        gol_bitboardSet(sim->board, i, j, field[i][j]);
+      }
+    }
+  }
+  return sim;
+}
+
+// Advances the simulation by the given amount of generations without any
+// allocation, the two buffers of the board are swapped every generation.
+void gol_run(GolSimulation *sim, uint64_t generations) {
+  if (sim == NULL || generations == 0) {
+    return;
+  } else {
+    pthread_mutex_lock(&sim->lock);
+    sim->jobGenerations = generations;
+    sim->jobId++;
+    pthread_cond_broadcast(&sim->wake);
+    pthread_mutex_unlock(&sim->lock);
+    // The barrier after the last generation makes sure all bands are done.
+    gol_simulationBand(sim, 0, generations);
+    if (generations & 1) {
+      uint64_t *temp = sim->board->cells;
+      sim->board->cells = sim->board->next;
+      sim->board->next = temp;
+    }
+    sim->generation += generations;
+  }
+}
+
+void gol_simulationDelete(GolSimulation *sim) {
+  if (sim != NULL) {
+    pthread_mutex_lock(&sim->lock);
+    sim->shutdown = 1;
+    pthread_cond_broadcast(&sim->wake);
+    pthread_mutex_unlock(&sim->lock);
+    for (uint32_t i = 1; i < sim->threads; i++) {
+      pthread_join(sim->workers[i], NULL);
+    }
+    pthread_barrier_destroy(&sim->barrier);
+    pthread_cond_destroy(&sim->wake);
+    pthread_mutex_destroy(&sim->lock);
+    gol_bitboardDelete(sim->board);
+    free(sim->workers);
+    free(sim);
+  }
+}
+
+// HashLife:
+
+// Initial amount of buckets of the node table and of nodes after which a step
+// collects the unused ones.
+#define GOL_HASHLIFE_BUCKETS 4096
+#define GOL_HASHLIFE_GC_THRESHOLD 1000000
+
+// Largest level of the root, the coordinates have to fit into int64_t.
+#define GOL_HASHLIFE_MAX_LEVEL 60
+
+static size_t gol_nodeHash(GolNode *nw, GolNode *ne, GolNode *sw,
+                           GolNode *se) {
+  uint64_t h = (uint64_t)(uintptr_t)nw * 0x9E3779B97F4A7C15ULL;
+  h = (h ^ (uint64_t)(uintptr_t)ne) * 0xBF58476D1CE4E5B9ULL;
+  h = (h ^ (uint64_t)(uintptr_t)sw) * 0x94D049BB133111EBULL;
+  h = (h ^ (uint64_t)(uintptr_t)se) * 0x9E3779B97F4A7C15ULL;
+  return (size_t)(h ^ (h >> 31));
+}
+
+// Doubles the amount of buckets of the node table.
+static void gol_nodeTableGrow(GolUniverse *universe) {
+  size_t size = universe->tableSize * 2;
+  GolNode **table = calloc(size, sizeof(GolNode *));
+  for (size_t i = 0; i < universe->tableSize; i++) {
+    GolNode *node = universe->table[i];
+    while (node != NULL) {
+      GolNode *next = node->hashNext;
+      size_t bucket =
+          gol_nodeHash(node->nw, node->ne, node->sw, node->se) & (size - 1);
+      node->hashNext = table[bucket];
+      table[bucket] = node;
+      node = next;
+    }
+  }
+  free(universe->table);
+  universe->table = table;
+  universe->tableSize = size;
+}
+
+// Returns the canonical node with the given quadrants. Equal subtrees are
+// stored only once, which is what makes the memoized results reusable.
+static GolNode *gol_nodeFind(GolUniverse *universe, GolNode *nw, GolNode *ne,
+                             GolNode *sw, GolNode *se) {
+  size_t hash = gol_nodeHash(nw, ne, sw, se);
+  GolNode *node = universe->table[hash & (universe->tableSize - 1)];
+  while (node != NULL) {
+    if (node->nw == nw && node->ne == ne && node->sw == sw && node->se == se) {
+      return node;
+    }
+    node = node->hashNext;
+  }
+  if (universe->nodeCount >= universe->tableSize) {
+    gol_nodeTableGrow(universe);
+  }
+  node = malloc(sizeof(GolNode));
+  node->nw = nw;
+  node->ne = ne;
+  node->sw = sw;
+  node->se = se;
+  node->result = NULL;
+  node->level = nw->level + 1;
+  node->marked = 0;
+  node->population =
+      nw->population + ne->population + sw->population + se->population;
+  size_t bucket = hash & (universe->tableSize - 1);
+  node->hashNext = universe->table[bucket];
+  universe->table[bucket] = node;
+  universe->nodeCount++;
+  return node;
+}
+
+// Returns the empty node of the given level.
+static GolNode *gol_nodeEmpty(GolUniverse *universe, uint32_t level) {
+  if (universe->empty[level] == NULL) {
+    GolNode *child = gol_nodeEmpty(universe, level - 1);
+    universe->empty[level] = gol_nodeFind(universe, child, child, child, child);
+  }
+  return universe->empty[level];
+}
+
+// Returns the node of level - 1 in the middle of the node.
+static GolNode *gol_nodeCenter(GolUniverse *universe, GolNode *node) {
+  return gol_nodeFind(universe, node->nw->se, node->ne->sw, node->sw->ne,
+                      node->se->nw);
+}
+
+// Advances the 4x4 cells of a level 2 node by one generation and returns the
+// 2x2 cells in the middle.
+static GolNode *gol_nodeLeafStep(GolUniverse *universe, GolNode *node) {
+  GolNode *quadrants[4] = {node->nw, node->ne, node->sw, node->se};
+  int cells[4][4];
+  for (int q = 0; q < 4; q++) {
+    GolNode *leaves[4] = {quadrants[q]->nw, quadrants[q]->ne, quadrants[q]->sw,
+                          quadrants[q]->se};
+    for (int l = 0; l < 4; l++) {
+      cells[(q / 2) * 2 + l / 2][(q % 2) * 2 + l % 2] =
+          (int)leaves[l]->population;
+    }
+  }
+  GolNode *next[4];
+  for (int i = 0; i < 4; i++) {
+    int row = 1 + i / 2, col = 1 + i % 2;
+    int aliveNeighbours = -cells[row][col];
+    for (int l = -1; l <= 1; l++) {
+      for (int m = -1; m <= 1; m++) {
+        aliveNeighbours += cells[row + l][col + m];
+      }
+    }
+    int alive = (aliveNeighbours == 3) || (aliveNeighbours == 2 && cells[row][col]);
+    next[i] = &universe->leaves[alive];
+  }
+  return gol_nodeFind(universe, next[0], next[1], next[2], next[3]);
+}
+
+// Returns the node of level - 1 in the middle of the node advanced by
+// 2^min(stepLog, level - 2) generations. The result is memoized in the node,
+// so every canonical node is only ever computed once per step size.
+static GolNode *gol_nodeSuccessor(GolUniverse *universe, GolNode *node) {
+  if (node->result != NULL) {
+    return node->result;
+  }
+  if (node->population == 0) {
+    return node->result = node->nw;
+  }
+  if (node->level == 2) {
+    return node->result = gol_nodeLeafStep(universe, node);
+  }
+  GolNode *nw = node->nw, *ne = node->ne, *sw = node->sw, *se = node->se;
+  // The nine overlapping nodes of level - 1 that cover the node.
+  GolNode *parts[9] = {
+      nw,
+      gol_nodeFind(universe, nw->ne, ne->nw, nw->se, ne->sw),
+      ne,
+      gol_nodeFind(universe, nw->sw, nw->se, sw->nw, sw->ne),
+      gol_nodeFind(universe, nw->se, ne->sw, sw->ne, se->nw),
+      gol_nodeFind(universe, ne->sw, ne->se, se->nw, se->ne),
+      sw,
+      gol_nodeFind(universe, sw->ne, se->nw, sw->se, se->sw),
+      se};
+  // Full speed advances both halves by 2^(level - 3), a smaller step only
+  // takes the middle of the parts and advances the second half.
+  int fullStep = (universe->stepLog >= node->level - 2);
+  for (int i = 0; i < 9; i++) {
+    parts[i] = fullStep ? gol_nodeSuccessor(universe, parts[i])
+                        : gol_nodeCenter(universe, parts[i]);
+  }
+  GolNode *quadrants[4];
+  for (int q = 0; q < 4; q++) {
+    int i = (q / 2) * 3 + q % 2;
+    quadrants[q] = gol_nodeSuccessor(
+        universe, gol_nodeFind(universe, parts[i], parts[i + 1], parts[i + 3],
+                               parts[i + 4]));
+  }
+  return node->result = gol_nodeFind(universe, quadrants[0], quadrants[1],
+                                     quadrants[2], quadrants[3]);
+}
+
+// Creates an empty universe. The universe is an unbounded plane, there is no
+// dead border like in gol_nextGen.
+GolUniverse *gol_hashlifeCreate(void) {
+  GolUniverse *universe = calloc(1, sizeof(GolUniverse));
+  universe->tableSize = GOL_HASHLIFE_BUCKETS;
+  universe->table = calloc(universe->tableSize, sizeof(GolNode *));
+  universe->gcThreshold = GOL_HASHLIFE_GC_THRESHOLD;
+  for (int i = 0; i < 2; i++) {
+    universe->leaves[i].level = 0;
+    universe->leaves[i].population = (uint64_t)i;
+  }
+  universe->empty[0] = &universe->leaves[0];
+  // Start with an 8x8 root whose top left cell is at (-4, -4).
+  universe->root = gol_nodeEmpty(universe, 3);
+  universe->originX = -4;
+  universe->originY = -4;
+  return universe;
+}
+
+void gol_hashlifeDelete(GolUniverse *universe) {
+  if (universe != NULL) {
+    for (size_t i = 0; i < universe->tableSize; i++) {
+      GolNode *node = universe->table[i];
+      while (node != NULL) {
+        GolNode *next = node->hashNext;
+        free(node);
+        node = next;
+      }
+    }
+    free(universe->table);
+    free(universe);
+  }
+}
+
+// Surrounds the root with empty space, the old root becomes the middle of the
+// new one.
+static void gol_hashlifeExpand(GolUniverse *universe) {
+  GolNode *root = universe->root;
+  GolNode *e = gol_nodeEmpty(universe, root->level - 1);
+  int64_t shift = (int64_t)1 << (root->level - 1);
+  universe->root = gol_nodeFind(
+      universe, gol_nodeFind(universe, e, e, e, root->nw),
+      gol_nodeFind(universe, e, e, root->ne, e),
+      gol_nodeFind(universe, e, root->sw, e, e),
+      gol_nodeFind(universe, root->se, e, e, e));
+  universe->originX -= shift;
+  universe->originY -= shift;
+}
+
+// Returns 1 if all living cells of the root are in its middle half.
+static int gol_hashlifeCentered(GolUniverse *universe) {
+  GolNode *root = universe->root;
+  if (root->level < 2) {
+    return root->population == 0;
+  }
+  return root->population == root->nw->se->population +
+                                 root->ne->sw->population +
+                                 root->sw->ne->population +
+                                 root->se->nw->population;
+}
+
+// Returns 1 if the cell is covered by the root.
+static int gol_hashlifeContains(GolUniverse *universe, int64_t x, int64_t y) {
+  int64_t size = (int64_t)1 << universe->root->level;
+  return x >= universe->originX && x - universe->originX < size &&
+         y >= universe->originY && y - universe->originY < size;
+}
+
+static GolNode *gol_nodeSetCell(GolUniverse *universe, GolNode *node,
+                                int64_t x, int64_t y, int alive) {
+  if (node->level == 0) {
+    return &universe->leaves[alive != 0];
+  } else {
+    int64_t half = (int64_t)1 << (node->level - 1);
+    GolNode *nw = node->nw, *ne = node->ne, *sw = node->sw, *se = node->se;
+    if (y < half) {
+      if (x < half) {
+        nw = gol_nodeSetCell(universe, nw, x, y, alive);
+      } else {
+        ne = gol_nodeSetCell(universe, ne, x - half, y, alive);
+      }
+    } else {
+      if (x < half) {
+        sw = gol_nodeSetCell(universe, sw, x, y - half, alive);
+      } else {
+        se = gol_nodeSetCell(universe, se, x - half, y - half, alive);
+      }
+    }
+    return gol_nodeFind(universe, nw, ne, sw, se);
+  }
+}
+
+// Sets the cell in column x and row y.
+void gol_hashlifeSetCell(GolUniverse *universe, int64_t x, int64_t y,
+                         int alive) {
+  if (universe == NULL) {
+    return;
+  } else {
+    while (!gol_hashlifeContains(universe, x, y)) {
+      if (universe->root->level >= GOL_HASHLIFE_MAX_LEVEL) {
+        fprintf(stderr, "The cell is outside of the universe!\n");
+        return;
+      }
+      gol_hashlifeExpand(universe);
+    }
+    universe->root =
+        gol_nodeSetCell(universe, universe->root, x - universe->originX,
+                        y - universe->originY, alive);
+  }
+}
+
+int gol_hashlifeGetCell(GolUniverse *universe, int64_t x, int64_t y) {
+  if (universe == NULL || !gol_hashlifeContains(universe, x, y)) {
+    return 0;
+  } else {
+    GolNode *node = universe->root;
+    x -= universe->originX;
+    y -= universe->originY;
+    while (node->level > 0 && node->population) {
+      int64_t half = (int64_t)1 << (node->level - 1);
+      if (y < half) {
+        node = (x < half) ? node->nw : node->ne;
+      } else {
+        node = (x < half) ? node->sw : node->se;
+        y -= half;
+      }
+      if (x >= half) {
+        x -= half;
+      }
+    }
+    return (int)node->population;
+  }
+}
+
+uint64_t gol_hashlifePopulation(GolUniverse *universe) {
+  return (universe == NULL) ? 0 : universe->root->population;
+}
+
+// Builds the node of the given level whose top left cell is field[y][x].
+static GolNode *gol_nodeFromField(GolUniverse *universe, int **field, int rows,
+                                  int cols, uint32_t level, int64_t x,
+                                  int64_t y) {
+  if (x >= cols || y >= rows) {
+    return gol_nodeEmpty(universe, level);
+  } else if (level == 0) {
+    return &universe->leaves[field[y][x] != 0];
+  } else {
+    int64_t half = (int64_t)1 << (level - 1);
+    return gol_nodeFind(
+        universe,
+        gol_nodeFromField(universe, field, rows, cols, level - 1, x, y),
+        gol_nodeFromField(universe, field, rows, cols, level - 1, x + half, y),
+        gol_nodeFromField(universe, field, rows, cols, level - 1, x, y + half),
+        gol_nodeFromField(universe, field, rows, cols, level - 1, x + half,
+                          y + half));
+  }
+}
+
+// Creates a universe from a field in the layout of gol_generateEmptyField,
+// field[row][col] becomes the cell in column col and row row.
+GolUniverse *gol_hashlifeFromField(int **field, int rows, int cols) {
+  if (field == NULL || rows <= 0 || cols <= 0) {
+    return NULL;
+  } else {
+    GolUniverse *universe = gol_hashlifeCreate();
+    uint32_t level = 3;
+    while (((int64_t)1 << level) < rows || ((int64_t)1 << level) < cols) {
+      level++;
+    }
+    universe->root =
+        gol_nodeFromField(universe, field, rows, cols, level, 0, 0);
+    universe->originX = 0;
+    universe->originY = 0;
+    return universe;
+  }
+}
+
+static void gol_nodeToField(GolNode *node, int **field, int rows, int cols,
+                            int64_t x, int64_t y) {
+  int64_t size = (int64_t)1 << node->level;
+  if (node->population == 0 || x >= cols || y >= rows || x + size <= 0 ||
+      y + size <= 0) {
+    return;
+  } else if (node->level == 0) {
+    field[y][x] = 1;
+  } else {
+    int64_t half = size / 2;
+    gol_nodeToField(node->nw, field, rows, cols, x, y);
+    gol_nodeToField(node->ne, field, rows, cols, x + half, y);
+    gol_nodeToField(node->sw, field, rows, cols, x, y + half);
+    gol_nodeToField(node->se, field, rows, cols, x + half, y + half);
+  }
+}
+
+// Writes the cells with columns [0, cols) and rows [0, rows) into a field in
+// the layout of gol_generateEmptyField, everything else is cut off.
+void gol_hashlifeCopyToField(GolUniverse *universe, int **field, int rows,
+                             int cols) {
+  if (universe == NULL || field == NULL) {
+    return;
+  } else {
+    for (int i = 0; i < rows; i++) {
+      memset(field[i], 0, (size_t)cols * sizeof(int));
+    }
+    gol_nodeToField(universe->root, field, rows, cols, universe->originX,
+                    universe->originY);
+  }
+}
+
+// Marks the node and everything below it as in use.
+static void gol_nodeMark(GolNode *node) {
+  while (node != NULL && node->level > 0 && !node->marked) {
+    node->marked = 1;
+    gol_nodeMark(node->nw);
+    gol_nodeMark(node->ne);
+    gol_nodeMark(node->sw);
+    node = node->se;
+  }
+}
+
+// Frees all nodes that can not be reached from the root. Memoized results of
+// the remaining nodes are dropped if they point to a freed node.
+void gol_hashlifeCollect(GolUniverse *universe) {
+  if (universe == NULL) {
+    return;
+  } else {
+    gol_nodeMark(universe->root);
+    for (int level = 0; level <= GOL_HASHLIFE_MAX_LEVEL + 1; level++) {
+      gol_nodeMark(universe->empty[level]);
+    }
+    for (size_t i = 0; i < universe->tableSize; i++) {
+      for (GolNode *node = universe->table[i]; node != NULL;
+           node = node->hashNext) {
+        if (node->marked && node->result != NULL && node->result->level > 0 &&
+            !node->result->marked) {
+          node->result = NULL;
+        }
+      }
+    }
+    for (size_t i = 0; i < universe->tableSize; i++) {
+      GolNode **link = &universe->table[i];
+      while (*link != NULL) {
+        GolNode *node = *link;
+        if (node->marked) {
+          node->marked = 0;
+          link = &node->hashNext;
+        } else {
+          *link = node->hashNext;
+          free(node);
+          universe->nodeCount--;
+        }
+      }
+    }
+    // Collect again once the table doubled its live nodes.
+    universe->gcThreshold = universe->nodeCount * 2 > GOL_HASHLIFE_GC_THRESHOLD
+                                ? universe->nodeCount * 2
+                                : GOL_HASHLIFE_GC_THRESHOLD;
+  }
+}
+
+// Advances the universe by 2^stepLog generations in one call.
+void gol_hashlifeStep(GolUniverse *universe, uint32_t stepLog) {
+  if (universe == NULL || stepLog > GOL_HASHLIFE_MAX_LEVEL - 3) {
+    return;
+  } else {
+    if (stepLog != universe->stepLog) {
+      // The memoized results are only valid for one step size.
+      for (size_t i = 0; i < universe->tableSize; i++) {
+        for (GolNode *node = universe->table[i]; node != NULL;
+             node = node->hashNext) {
+          node->result = NULL;
+        }
+      }
+      universe->stepLog = stepLog;
+    }
+    // The pattern has to be in the middle half and the root large enough for
+    // the step. One more level leaves room for the pattern to grow.
+    while (universe->root->level < stepLog + 2 ||
+           !gol_hashlifeCentered(universe)) {
+      gol_hashlifeExpand(universe);
+    }
+    gol_hashlifeExpand(universe);
+    int64_t shift = (int64_t)1 << (universe->root->level - 2);
+    universe->root = gol_nodeSuccessor(universe, universe->root);
+    universe->originX += shift;
+    universe->originY += shift;
+    universe->generation += (uint64_t)1 << stepLog;
+    if (universe->nodeCount > universe->gcThreshold) {
+      gol_hashlifeCollect(universe);
+    }
+  }
+}
+
+// Advances the universe by any amount of generations, one power of two step
+// per set bit.
+void gol_hashlifeRun(GolUniverse *universe, uint64_t generations) {
+  for (uint32_t bit = 0; universe != NULL && generations; bit++) {
+    if (generations & 1) {
+      gol_hashlifeStep(universe, bit);
+    }
+    generations >>= 1;
+  }
+}
+
+// Loads a pattern in the run length encoded format used by most Life
+// programs into the universe, its top left cell goes to (0, 0). Returns 0 if
+// the pattern is malformed.
+int gol_hashlifeLoadRLE(GolUniverse *universe, const char *rle) {
+  if (universe == NULL || rle == NULL) {
+    return 0;
+  } else {
+    const char *itr = rle;
+    int64_t x = 0, y = 0, count = 0;
+    // Skip the comment lines and the header line.
+    while (*itr == '#' || *itr == 'x' || *itr == '\n' || *itr == '\r') {
+      while (*itr != '\0' && *itr != '\n') {
+        itr++;
+      }
+      if (*itr == '\n') {
+        itr++;
+      }
+    }
+    for (; *itr != '\0' && *itr != '!'; itr++) {
+      if (*itr >= '0' && *itr <= '9') {
+        count = count * 10 + (*itr - '0');
+        continue;
+      }
+      int64_t run = count ? count : 1;
+      count = 0;
+      if (*itr == 'b' || *itr == '.') {
+        x += run;
+      } else if (*itr == 'o' || *itr == 'A') {
+        for (int64_t i = 0; i < run; i++) {
+          gol_hashlifeSetCell(universe, x++, y, 1);
+        }
+      } else if (*itr == '$') {
+        y += run;
+        x = 0;
+      } else if (*itr != ' ' && *itr != '\t' && *itr != '\n' && *itr != '\r') {
+        return 0;
+      }
+    }
+    return *itr == '!';
+  }
+}
+
+// Collects the coordinates of all living cells below the node.
+static void gol_nodeCollectCells(GolNode *node, int64_t x, int64_t y,
+                                 int64_t *cells, uint64_t *count) {
+  if (node->population == 0) {
+    return;
+  } else if (node->level == 0) {
+    cells[2 * *count] = y;
+    cells[2 * *count + 1] = x;
+    (*count)++;
+  } else {
+    int64_t half = (int64_t)1 << (node->level - 1);
+    gol_nodeCollectCells(node->nw, x, y, cells, count);
+    gol_nodeCollectCells(node->ne, x + half, y, cells, count);
+    gol_nodeCollectCells(node->sw, x, y + half, cells, count);
+    gol_nodeCollectCells(node->se, x + half, y + half, cells, count);
+  }
+}
+
+static int gol_compareCells(const void *a, const void *b) {
+  const int64_t *first = a, *second = b;
+  if (first[0] != second[0]) {
+    return (first[0] < second[0]) ? -1 : 1;
+  }
+  return (first[1] < second[1]) ? -1 : (first[1] > second[1]);
+}
+
+// Appends a run to the RLE string, the lines are kept below 70 characters.
+static void gol_rleAppend(char *out, size_t *length, size_t *lineLength,
+                          uint64_t run, char tag) {
+  char token[32];
+  int written = (run > 1) ? snprintf(token, sizeof(token), "%llu%c",
+                                     (unsigned long long)run, tag)
+                          : snprintf(token, sizeof(token), "%c", tag);
+  if (*lineLength + written > 70) {
+    out[(*length)++] = '\n';
+    *lineLength = 0;
+  }
+  memcpy(out + *length, token, (size_t)written);
+  *length += written;
+  *lineLength += written;
+}
+
+// Returns the living cells of the universe as a malloc'ed RLE string. The
+// header holds the size of the bounding box, the pattern starts with its top
+// left corner.
+char *gol_hashlifeToRLE(GolUniverse *universe) {
+  if (universe == NULL) {
+    return NULL;
+  } else {
+    uint64_t population = universe->root->population, count = 0;
+    int64_t *cells = malloc((2 * population + 2) * sizeof(int64_t));
+    gol_nodeCollectCells(universe->root, universe->originX, universe->originY,
+                         cells, &count);
+    qsort(cells, count, 2 * sizeof(int64_t), gol_compareCells);
+    int64_t minX = 0, maxX = -1, minY = 0, maxY = -1;
+    for (uint64_t i = 0; i < count; i++) {
+      int64_t y = cells[2 * i], x = cells[2 * i + 1];
+      if (i == 0 || x < minX) {
+        minX = x;
+      }
+      if (i == 0 || x > maxX) {
+        maxX = x;
+      }
+      minY = (i == 0) ? y : minY;
+      maxY = y;
+    }
+    // Every cell adds at most one token for itself and one for the gap
+    // before it, each of at most 21 characters plus a line break.
+    char *out = malloc(128 + count * 46);
+    size_t length = (size_t)sprintf(
+        out, "x = %lld, y = %lld, rule = B3/S23\n",
+        (long long)(maxX - minX + 1), (long long)(maxY - minY + 1));
+    size_t lineLength = 0;
+    int64_t x = minX, y = minY;
+    for (uint64_t i = 0; i < count;) {
+      int64_t cellY = cells[2 * i], cellX = cells[2 * i + 1];
+      if (cellY > y) {
+        gol_rleAppend(out, &length, &lineLength, (uint64_t)(cellY - y), '$');
+        y = cellY;
+        x = minX;
+      }
+      if (cellX > x) {
+        gol_rleAppend(out, &length, &lineLength, (uint64_t)(cellX - x), 'b');
+      }
+      // Merge the following cells of the row into one run.
+      uint64_t run = 1;
+      while (i + run < count && cells[2 * (i + run)] == cellY &&
+             cells[2 * (i + run) + 1] == cellX + (int64_t)run) {
+        run++;
+      }
+      gol_rleAppend(out, &length, &lineLength, run, 'o');
+      x = cellX + (int64_t)run;
+      i += run;
+    }
+    out[length++] = '!';
+    out[length++] = '\n';
+    out[length] = '\0';
+    free(cells);
+    return out;
+  }
+}
+
+void gol_printField(int **field, int width, int height) {
+  for (int i = 0; i < height; i++) {
+    for (int j = 0; j < width; j++) {
+      if (!field[i][j]) {
+        printf(" .");
+      } else {
+        printf(" #");
+      }
+    }
+    printf("\n");
+  }
+}
+
+// Does not currently work as well as it should.
+void gol_setField(int **field, int width, int height) {
+  while (1) {
+    printf("BItte geben sie die position ein: ");
+    int row = 0, col = 0, val = 0;
+    scanf("%d.%d %d", &row, &col, &val);
+    if ((col < 0) || (col > width) || (col < 0)) {
+      return;
+    }
+    if ((row < 0) || (row > height) || (row < 0)) {
+      return;
+    }
+    if ((val < 0) || (val > 1) || val == -1) {
+      return;
+    }
+    field[row][col] = val;
+  }
+}
+
+// Allocators:
+
+// Blocks handed out by the pool are aligned to this many bytes, the payload of
+// a co-allocated node starts at the next multiple of it after the node.
+#define ALGO_BLOCK_ALIGN 16
+#define ALGO_ALIGN_UP(size)                                                    \
+  (((size) + ALGO_BLOCK_ALIGN - 1) & ~(size_t)(ALGO_BLOCK_ALIGN - 1))
+
+static void *pool_allocContext(void *context, size_t size) {
+  return pool_alloc(context, size);
+}
+
+static void pool_freeContext(void *context, void *block, size_t size) {
+  pool_free(context, block, size);
+}
+
+static void pool_resetContext(void *context) { pool_reset(context); }
+
+// Creates a pool for blocks of up to blockSize bytes, the slabs hold
+// blocksPerSlab of them.
+PoolAllocator *pool_create(size_t blockSize, size_t blocksPerSlab) {
+  if (blockSize == 0 || blocksPerSlab == 0) {
+    return NULL;
+  } else {
+    PoolAllocator *pool = calloc(1, sizeof(PoolAllocator));
+    if (pool == NULL) {
+      return NULL;
+    }
+    // Every block has to be able to hold the link of the free list.
+    if (blockSize < sizeof(void *)) {
+      blockSize = sizeof(void *);
+    }
+    pool->blockSize = ALGO_ALIGN_UP(blockSize);
+    pool->blocksPerSlab = blocksPerSlab;
+    pool->allocator.alloc = pool_allocContext;
+    pool->allocator.free = pool_freeContext;
+    pool->allocator.reset = pool_resetContext;
+    pool->allocator.context = pool;
+    return pool;
+  }
+}
+
+// Moves the bump pointer to the next slab, which is allocated on first use.
+static int pool_nextSlab(PoolAllocator *pool) {
+  size_t next = (pool->bump == NULL) ? 0 : pool->currentSlab + 1;
+  if (next == pool->slabCount) {
+    if (pool->slabCount == pool->slabCapacity) {
+      size_t capacity = pool->slabCapacity ? pool->slabCapacity * 2 : 8;
+      uint8_t **slabs = realloc(pool->slabs, capacity * sizeof(uint8_t *));
+      if (slabs == NULL) {
+        return 0;
+      }
+      pool->slabs = slabs;
+      pool->slabCapacity = capacity;
+    }
+    // Cache line aligned, so no block straddles more lines than it has to.
+    size_t bytes = (pool->blockSize * pool->blocksPerSlab + 63) & ~(size_t)63;
+    uint8_t *slab = aligned_alloc(64, bytes);
+    if (slab == NULL) {
+      return 0;
+    }
+    pool->slabs[pool->slabCount++] = slab;
+  }
+  pool->currentSlab = next;
+  pool->bump = pool->slabs[next];
+  pool->bumpEnd = pool->bump + pool->blockSize * pool->blocksPerSlab;
+  return 1;
+}
+
+// Returns a block of at least size bytes. Freed blocks are reused first, then
+// the current slab is bumped.
+void *pool_alloc(PoolAllocator *pool, size_t size) {
+  if (pool == NULL) {
+    return NULL;
+  } else if (size > pool->blockSize) {
+    // Too large for the slabs, the block is linked into the large list so a
+    // reset can find it.
+    PoolLargeBlock *block = malloc(sizeof(PoolLargeBlock) + size);
+    if (block == NULL) {
+      return NULL;
+    }
+    block->prev = NULL;
+    block->next = pool->large;
+    if (pool->large != NULL) {
+      pool->large->prev = block;
+    }
+    pool->large = block;
+    return block + 1;
+  } else if (pool->freeList != NULL) {
+    void *block = pool->freeList;
+    pool->freeList = *(void **)block;
+    return block;
+  } else {
+    if (pool->bump == pool->bumpEnd && !pool_nextSlab(pool)) {
+      return NULL;
+    }
+    void *block = pool->bump;
+    pool->bump += pool->blockSize;
+    return block;
+  }
+}
+
+// Gives a block back to the pool, size has to be the size it was allocated
+// with.
+void pool_free(PoolAllocator *pool, void *block, size_t size) {
+  if (pool == NULL || block == NULL) {
+    return;
+  } else if (size > pool->blockSize) {
+    PoolLargeBlock *large = (PoolLargeBlock *)block - 1;
+    if (large->prev != NULL) {
+      large->prev->next = large->next;
+    } else {
+      pool->large = large->next;
+    }
+    if (large->next != NULL) {
+      large->next->prev = large->prev;
+    }
+    free(large);
+  } else {
+    *(void **)block = pool->freeList;
+    pool->freeList = block;
+  }
+}
+
+// Releases every block of the pool at once. The slabs are kept and handed out
+// again, only the large blocks are returned to malloc.
+void pool_reset(PoolAllocator *pool) {
+  if (pool == NULL) {
+    return;
+  } else {
+    while (pool->large != NULL) {
+      PoolLargeBlock *next = pool->large->next;
+      free(pool->large);
+      pool->large = next;
+    }
+    pool->freeList = NULL;
+    pool->currentSlab = 0;
+    pool->bump = NULL;
+    pool->bumpEnd = NULL;
+  }
+}
+
+void pool_delete(PoolAllocator **pool) {
+  if (pool == NULL || *pool == NULL) {
+    return;
+  } else {
+    pool_reset(*pool);
+    for (size_t i = 0; i < (*pool)->slabCount; i++) {
+      free((*pool)->slabs[i]);
+    }
+    free((*pool)->slabs);
+    free(*pool);
+    *pool = NULL;
+  }
+}
+
+// Allocates a node of nodeSize bytes followed by dataSize bytes of data. With
+// an allocator both live in one block, otherwise in two malloc blocks. The
+// data pointer is written to data, container selects the counters. Returns
+// NULL if the allocator or malloc fail.
+static void *algo_allocNode(Allocator *allocator, size_t nodeSize,
+                            size_t dataSize, void **data,
+                            AlgoInstrContainer container) {
+  if (allocator != NULL) {
+    size_t size = ALGO_ALIGN_UP(nodeSize) + dataSize;
+    uint8_t *block = allocator->alloc(allocator->context, size);
+    if (block == NULL) {
+      return NULL;
+    }
+    *data = block + ALGO_ALIGN_UP(nodeSize);
+    ALGO_INSTR_ALLOC(container, 1, size);
+    return block;
+  } else {
+    void *block = malloc(nodeSize);
+    *data = malloc(dataSize);
+    if (block == NULL || (*data == NULL && dataSize != 0)) {
+      free(block);
+      free(*data);
+      return NULL;
+    }
+    ALGO_INSTR_ALLOC(container, 2, nodeSize + dataSize);
+    return block;
+  }
+}
+
+// Releases a node allocated by algo_allocNode.
+static void algo_freeNode(Allocator *allocator, void *block, size_t nodeSize,
+                          void *data, size_t dataSize,
+                          AlgoInstrContainer container) {
+  if (allocator != NULL) {
+    allocator->free(allocator->context, block,
+                    ALGO_ALIGN_UP(nodeSize) + dataSize);
+    ALGO_INSTR_FREE(container, 1);
+  } else {
+    free(data);
+    free(block);
+    ALGO_INSTR_FREE(container, 2);
+  }
+}
+
+// Id index of the linked list:
+
+// Slot where the search for the id starts, Fibonacci hashing spreads the
+// consecutive ids over the table. The slot comes from the high bits of the
+// product, which depend on all bits of the id.
+static uint64_t llist_indexSlot(LlistIndex *index, uint64_t id) {
+  return (id * 0x9E3779B97F4A7C15ULL) >>
+         (64 - __builtin_ctzll(index->capacity));
+}
+
+// Returns the entry of the id or NULL.
+static LlistIndexEntry *llist_indexFind(LlistIndex *index, uint64_t id) {
+  uint64_t slot = llist_indexSlot(index, id);
+  while (index->entries[slot].item != NULL) {
+    if (index->entries[slot].id == id) {
+      return &index->entries[slot];
+    }
+    slot = (slot + 1) & (index->capacity - 1);
+  }
+  return NULL;
+}
+
+static int llist_indexResize(LlistIndex *index, uint64_t capacity);
+
+// Adds the node to the index, growing it before it gets more than half full.
+static int llist_indexInsert(LlistIndex *index, node *item, node *prev) {
+  if (2 * (index->count + 1) > index->capacity &&
+      !llist_indexResize(index, index->capacity * 2)) {
+    return 0;
+  }
+  uint64_t slot = llist_indexSlot(index, item->id);
+  while (index->entries[slot].item != NULL) {
+    slot = (slot + 1) & (index->capacity - 1);
+  }
+  index->entries[slot].id = item->id;
+  index->entries[slot].item = item;
+  index->entries[slot].prev = prev;
+  index->count++;
+  return 1;
+}
+
+// Rehashes every entry into a table with the new capacity.
+static int llist_indexResize(LlistIndex *index, uint64_t capacity) {
+  LlistIndexEntry *old = index->entries;
+  uint64_t oldCapacity = index->capacity;
+  index->entries = calloc(capacity, sizeof(LlistIndexEntry));
+  if (index->entries == NULL) {
+    index->entries = old;
+    return 0;
+  }
+  index->capacity = capacity;
+  index->count = 0;
+  for (uint64_t i = 0; i < oldCapacity; i++) {
+    if (old[i].item != NULL) {
+      llist_indexInsert(index, old[i].item, old[i].prev);
+    }
+  }
+  free(old);
+  return 1;
+}
+
+// Removes the entry and moves the following entries of the probe sequence
+// back, so the table never needs tombstones.
+static void llist_indexErase(LlistIndex *index, LlistIndexEntry *entry) {
+  uint64_t mask = index->capacity - 1;
+  uint64_t hole = (uint64_t)(entry - index->entries);
+  uint64_t slot = (hole + 1) & mask;
+  while (index->entries[slot].item != NULL) {
+    uint64_t home = llist_indexSlot(index, index->entries[slot].id);
+    // The entry may fill the hole if the hole lies between its home slot and
+    // its current slot.
+    if (((slot - home) & mask) >= ((slot - hole) & mask)) {
+      index->entries[hole] = index->entries[slot];
+      hole = slot;
+    }
+    slot = (slot + 1) & mask;
+  }
+  index->entries[hole].item = NULL;
+  index->count--;
+}
+
+static void llist_indexClear(LlistIndex *index) {
+  memset(index->entries, 0, index->capacity * sizeof(LlistIndexEntry));
+  index->count = 0;
+}
+
+// Sets the predecessor stored for the node, if it has an entry.
+static void llist_indexSetPrev(LlistIndex *index, node *item, node *prev) {
+  if (item != NULL) {
+    LlistIndexEntry *entry = llist_indexFind(index, item->id);
+    if (entry != NULL) {
+      entry->prev = prev;
+    }
+  }
+}
+
+// Builds an id index over the list, from then on it is kept up to date by
+// llist_appendItem, llist_deleteItem and llist_merge and llist_findItem and
+// llist_deleteItem take O(1) on average. The ids have to be unique.
+int llist_enableIndex(LinkedList *list) {
+  if (list == NULL) {
+    return 0;
+  } else if (list->index != NULL) {
+    return 1;
+  } else {
+    LlistIndex *index = malloc(sizeof(LlistIndex));
+    if (index == NULL) {
+      return 0;
+    }
+    index->capacity = 16;
+    index->count = 0;
+    index->entries = calloc(index->capacity, sizeof(LlistIndexEntry));
+    if (index->entries == NULL) {
+      free(index);
+      return 0;
+    }
+    node *prev = NULL;
+    for (node *itrVar = list->front; itrVar != NULL; itrVar = itrVar->next) {
+      // A duplicate id, e.g. from an old merge, or a failed resize.
+      if (llist_indexFind(index, itrVar->id) != NULL ||
+          !llist_indexInsert(index, itrVar, prev)) {
+        free(index->entries);
+        free(index);
+        return 0;
+      }
+      prev = itrVar;
+    }
+    list->index = index;
+    return 1;
+  }
+}
+
+void llist_disableIndex(LinkedList *list) {
+  if (list != NULL && list->index != NULL) {
+    free(list->index->entries);
+    free(list->index);
+    list->index = NULL;
+  }
+}
+
+// Create the linked list.
+LinkedList *llist_createList(void *data, size_t dataSize) {
+  return llist_createListWithAllocator(data, dataSize, NULL);
+}
+
+// Create the linked list, its nodes are taken from the allocator.
+LinkedList *llist_createListWithAllocator(void *data, size_t dataSize,
+                                          Allocator *allocator) {
+  if (data == NULL) {
+    return NULL;
+  } else {
+    LinkedList *list = (LinkedList *)malloc(sizeof(LinkedList));
+    if (list == NULL) {
+      return NULL;
+    }
+    list->allocator = allocator;
+    list->index = NULL;
+    list->front = NULL;
+    list->back = NULL;
+    list->globalId = 0;
+    if (llist_appendItem(list, data, dataSize) == UINT64_MAX) {
+      free(list);
+      return NULL;
+    }
+    return list;
+  }
+}
+
+// Returns the id of the new node, UINT64_MAX if it could not be allocated.
+uint64_t llist_appendItem(LinkedList *list, void *data, uint64_t dataSize) {
+  if (list == NULL || data == NULL) {
+    return UINT64_MAX;
+  }
+  void *payload = NULL;
+  node *temp =
+      algo_allocNode(list->allocator, sizeof(node), dataSize, &payload,
+                     ALGO_INSTR_LLIST);
+  if (temp == NULL) {
+    return UINT64_MAX;
+  }
+  // The first node of a list gets the id 0.
+  uint64_t id = (list->front == NULL) ? 0 : list->globalId + 1;
+
+  // Copy the data into the node.
+  temp->data = payload;
+  memcpy(temp->data, data, dataSize);
+  temp->dataSize = dataSize;
+  temp->id = id;
+  temp->next = NULL;
+
+  // The node is not linked yet, so a failed insert only has to free it.
+  if (list->index != NULL &&
+      !llist_indexInsert(list->index, temp, list->front ? list->back : NULL)) {
+    algo_freeNode(list->allocator, temp, sizeof(node), payload, dataSize,
+                  ALGO_INSTR_LLIST);
+    return UINT64_MAX;
+  }
+  list->globalId = id;
+  if (list->front == NULL) {
+    list->front = temp;
+  } else {
+    list->back->next = temp;
+  }
+  list->back = temp;
+  return id;
+}
+
+int llist_printList(LinkedList *list, void (*outputData)(node *)) {
+  int position = 0;
+  node *itrVar = list->front;
+  if (itrVar == NULL) {
+    fprintf(stderr, "The list is empty!\n");
+    return 0;
+  } else {
+    while (itrVar != NULL) {
+      printf("\nPosition: %d,  \n", position++);
+      printf("ID: %d\n", itrVar->id);
+      outputData(itrVar);
+      itrVar = itrVar->next;
+    }
+  }
+  itrVar = NULL;
+  return 1;
+}
+
+node *llist_findItem(LinkedList *list, uint32_t id) {
+  if (list->index != NULL) {
+    LlistIndexEntry *entry = llist_indexFind(list->index, id);
+    ALGO_INSTR_TRAVERSAL(ALGO_INSTR_LLIST, 0);
+    return (entry != NULL) ? entry->item : NULL;
+  }
+  ALGO_INSTR_SCOPE_BEGIN(llist_findItem);
+  node *itrVar = list->front;
+  uint64_t steps = 0;
+  while (itrVar != NULL && itrVar->id != id) {
+    itrVar = itrVar->next;
+    steps++;
+  }
+  ALGO_INSTR_TRAVERSAL(ALGO_INSTR_LLIST, steps);
+  ALGO_INSTR_SCOPE_END(llist_findItem);
+  return itrVar;
+}
+
+// Frees a node of the list together with its data. Without an allocator
+// freefunc releases the data block like free, as it always did. With an
+// allocator the data lives in the block of the node, so freefunc only
+// releases what the data points to and the block goes back to the allocator.
+// A NULL freefunc leaves the data block to the library in both cases.
+static void llist_freeNode(LinkedList *list, node *item,
+                           void (*freefunc)(void *data)) {
+  if (list->allocator == NULL && freefunc != NULL) {
+    freefunc(item->data);
+    free(item);
+    ALGO_INSTR_FREE(ALGO_INSTR_LLIST, 2);
+  } else {
+    if (freefunc != NULL) {
+      freefunc(item->data);
+    }
+    algo_freeNode(list->allocator, item, sizeof(node), item->data,
+                  item->dataSize, ALGO_INSTR_LLIST);
+  }
+}
+
+void llist_deleteList(LinkedList *list, void (*freefunc)(void *data)) {
+  // Initializing the variables used for the iteration and the deletion.
+  node *itrVar = list->front;
+  node *freeVar = NULL;
+
+  while (itrVar != NULL) {
+    freeVar = itrVar;
+    itrVar = itrVar->next;
+    llist_freeNode(list, freeVar, freefunc);
+  };
+  // Sets the pointers front and back to point to nothing as the final step.
+  list->back = NULL;
+  list->front = NULL;
+  list->globalId = 0;
+  if (list->index != NULL) {
+    llist_indexClear(list->index);
+  }
+}
+
+// Unlinks the node with the id in O(1) using the index.
+static void llist_deleteIndexed(LinkedList *list, uint32_t id,
+                                void (*freefunc)(void *data)) {
+  LlistIndexEntry *entry = llist_indexFind(list->index, id);
+  if (entry == NULL) {
+    return;
+  }
+  node *item = entry->item, *prev = entry->prev;
+  llist_indexErase(list->index, entry);
+  if (prev == NULL) {
+    list->front = item->next;
+  } else {
+    prev->next = item->next;
+  }
+  if (list->back == item) {
+    list->back = prev;
+  }
+  llist_indexSetPrev(list->index, item->next, prev);
+  llist_freeNode(list, item, freefunc);
+}
+
+void llist_deleteItem(LinkedList *list, uint32_t id,
+                      void (*freefunc)(void *data)) {
+  node *temp = NULL, *itrVar = NULL;
+  if (list->index != NULL) {
+    llist_deleteIndexed(list, id, freefunc);
+    return;
+  }
+  // If the list is empty or the id was never handed out, end the function.
+  // The ids of the nodes are not ordered after llist_sort, so only the upper
+  // bound of globalId can rule out an id.
+  if (list->front == NULL || id > list->globalId) {
+    return;
+    // If the id is in the front.
+  } else if (list->front->id == id) {
+    temp = list->front;
+    list->front = list->front->next;
+    if (list->front == NULL) {
+      list->back = NULL;
+    }
+    llist_freeNode(list, temp, freefunc);
+
+    // If the id is in the back.
+  } else if (list->back->id == id) {
+    itrVar = list->front;
+    uint64_t steps = 0;
+    while (itrVar->next != NULL) {
+      temp = itrVar;
+      itrVar = itrVar->next;
+      steps++;
+    }
+    ALGO_INSTR_TRAVERSAL(ALGO_INSTR_LLIST, steps);
+    list->back = temp;
+    temp->next = NULL;
+    llist_freeNode(list, itrVar, freefunc);
+    // If the id is somewhere between front and back.
+  } else {
+    itrVar = list->front;
+    uint64_t steps = 0;
+    while (itrVar != NULL && itrVar->id != id) {
+      temp = itrVar;
+      itrVar = itrVar->next;
+      steps++;
+    }
+    ALGO_INSTR_TRAVERSAL(ALGO_INSTR_LLIST, steps);
+    if (itrVar == NULL) {
+      return;
+    }
+    temp->next = itrVar->next;
+    llist_freeNode(list, itrVar, freefunc);
+  }
+  temp = NULL;
+  itrVar = NULL;
+}
+
+// Appends a linked list to the end of the second linked list. Both lists have
+// to use the same allocator, the appended list is empty afterwards. The
+// appended nodes get new ids following the globalId of the first list, so the
+// ids stay unique, with or without an index.
+int llist_merge(LinkedList *start, LinkedList *appendedList) {
+  if (start == NULL || appendedList == NULL ||
+      start->allocator != appendedList->allocator) {
+    return 0;
+  } else if (appendedList->front == NULL) {
+    return 1;
+  } else {
+    node *prev = start->front ? start->back : NULL;
+    for (node *itrVar = appendedList->front; itrVar != NULL;
+         itrVar = itrVar->next) {
+      itrVar->id = (prev == NULL) ? (start->globalId = 0) : ++start->globalId;
+      // Without the memory for the index the list falls back to the walks.
+      if (start->index != NULL &&
+          !llist_indexInsert(start->index, itrVar, prev)) {
+        llist_disableIndex(start);
+      }
+      prev = itrVar;
+    }
+    if (start->front == NULL) {
+      start->front = appendedList->front;
+    } else {
+      start->back->next = appendedList->front;
+    }
+    start->back = appendedList->back;
+    appendedList->front = NULL;
+    appendedList->back = NULL;
+    if (appendedList->index != NULL) {
+      llist_indexClear(appendedList->index);
+    }
+    return 1;
+  }
+}
+
+// Drops every node of the list in O(1) by resetting its allocator. No other
+// container may take nodes from the same allocator.
+int llist_resetArena(LinkedList *list) {
+  if (list == NULL || list->allocator == NULL ||
+      list->allocator->reset == NULL) {
+    return 0;
+  } else {
+    list->allocator->reset(list->allocator->context);
+    list->front = NULL;
+    list->back = NULL;
+    list->globalId = 0;
+    if (list->index != NULL) {
+      llist_indexClear(list->index);
+    }
+    return 1;
+  }
+}
+
+// Prints the time per operation to find random ids, to delete the back and to
+// delete random ids of a list of count items, with and without the index.
+void llist_indexBenchmark(uint64_t count) {
+  // The linear walks take O(count) each, so they get fewer operations.
+  uint64_t operations[2] = {64, 1 << 16};
+  double times[2][3];
+  // Keeps the lookups from being optimized away.
+  uint64_t sums[2] = {0, 0};
+  for (int indexed = 0; indexed < 2; indexed++) {
+    uint64_t value = 0, state = 1;
+    uint64_t ops = operations[indexed];
+    LinkedList *list = llist_createList(&value, sizeof(value));
+    if (indexed) {
+      llist_enableIndex(list);
+    }
+    for (uint64_t i = 1; i < count; i++) {
+      llist_appendItem(list, &i, sizeof(i));
+    }
+    double start = algo_seconds();
+    for (uint64_t i = 0; i < ops; i++) {
+      uint64_t id = algo_random(&state) % count;
+      sums[indexed] += *(uint64_t *)llist_findItem(list, (uint32_t)id)->data;
+    }
+    times[indexed][0] = (algo_seconds() - start) / (double)ops;
+    start = algo_seconds();
+    for (uint64_t i = 0; i < 64; i++) {
+      llist_deleteItem(list, (uint32_t)list->back->id, NULL);
+    }
+    times[indexed][1] = (algo_seconds() - start) / 64.0;
+    start = algo_seconds();
+    for (uint64_t i = 0; i < ops; i++) {
+      llist_deleteItem(list, (uint32_t)(algo_random(&state) % count), NULL);
+    }
+    times[indexed][2] = (algo_seconds() - start) / (double)ops;
+    llist_deleteList(list, NULL);
+    llist_disableIndex(list);
+    free(list);
+  }
+  printf("%-10s %-14s %-14s %-14s\n", "list", "find ns", "delete back",
+         "delete ns");
+  const char *names[] = {"linear", "indexed"};
+  for (int i = 0; i < 2; i++) {
+    printf("%-10s %-14.1f %-14.1f %-14.1f\n", names[i], times[i][0] * 1e9,
+           times[i][1] * 1e9, times[i][2] * 1e9);
+  }
+}
+
+// List sorting:
+
+// Sorted and linked run of nodes of a list sort.
+typedef struct {
+  void *head;
+  void *tail;
+  uint64_t length;
+} AlgoSortRun;
+
+// The sort works on any list node type, it reaches the link to the next node
+// and the data pointer of a node through their offsets.
+#define ALGO_SORT_FIELD(item, offset) (*(void **)((char *)(item) + (offset)))
+
+// Merges two runs, on equal elements the one of the first run comes first.
+// If the runs are already in order they are only concatenated, which makes
+// nearly sorted input cheap.
+static AlgoSortRun algo_sortMerge(AlgoSortRun first, AlgoSortRun second,
+                                  size_t nextOffset, size_t dataOffset,
+                                  int (*comparefunc)(const void *,
+                                                     const void *)) {
+  AlgoSortRun merged = {NULL, NULL, first.length + second.length};
+  if (comparefunc(ALGO_SORT_FIELD(first.tail, dataOffset),
+                  ALGO_SORT_FIELD(second.head, dataOffset)) <= 0) {
+    ALGO_SORT_FIELD(first.tail, nextOffset) = second.head;
+    merged.head = first.head;
+    merged.tail = second.tail;
+    return merged;
+  }
+  void **link = &merged.head;
+  void *left = first.head, *right = second.head;
+  while (left != NULL && right != NULL) {
+    if (comparefunc(ALGO_SORT_FIELD(right, dataOffset),
+                    ALGO_SORT_FIELD(left, dataOffset)) < 0) {
+      *link = right;
+      link = &ALGO_SORT_FIELD(right, nextOffset);
+      right = *link;
+    } else {
+      *link = left;
+      link = &ALGO_SORT_FIELD(left, nextOffset);
+      left = *link;
+    }
+  }
+  *link = (left != NULL) ? left : right;
+  merged.tail = (left != NULL) ? first.tail : second.tail;
+  return merged;
+}
+
+// Detaches the longest run at the start of the nodes behind *rest. A strictly
+// descending run gets reversed, the reversal can not change the order of
+// equal elements.
+static AlgoSortRun algo_sortNextRun(void **rest, size_t nextOffset,
+                                    size_t dataOffset,
+                                    int (*comparefunc)(const void *,
+                                                       const void *)) {
+  AlgoSortRun run = {*rest, *rest, 1};
+  void *next = ALGO_SORT_FIELD(run.head, nextOffset);
+  if (next != NULL && comparefunc(ALGO_SORT_FIELD(run.head, dataOffset),
+                                  ALGO_SORT_FIELD(next, dataOffset)) > 0) {
+    void *last = run.head;
+    ALGO_SORT_FIELD(run.tail, nextOffset) = NULL;
+    while (next != NULL &&
+           comparefunc(ALGO_SORT_FIELD(last, dataOffset),
+                       ALGO_SORT_FIELD(next, dataOffset)) > 0) {
+      void *following = ALGO_SORT_FIELD(next, nextOffset);
+      ALGO_SORT_FIELD(next, nextOffset) = run.head;
+      run.head = next;
+      last = next;
+      next = following;
+      run.length++;
+    }
+  } else {
+    while (next != NULL &&
+           comparefunc(ALGO_SORT_FIELD(run.tail, dataOffset),
+                       ALGO_SORT_FIELD(next, dataOffset)) <= 0) {
+      run.tail = next;
+      next = ALGO_SORT_FIELD(next, nextOffset);
+      run.length++;
+    }
+    ALGO_SORT_FIELD(run.tail, nextOffset) = NULL;
+  }
+  *rest = next;
+  return run;
+}
+
+// Stable natural merge sort over the nodes starting at head, only the links
+// get changed. The pending runs are merged like in Timsort: a run may not be
+// longer than the sum of the two runs above it on the stack, which keeps the
+// merges balanced and the stack at O(log n) runs. Returns the new head and
+// writes the new tail to tail.
+static void *algo_sortList(void *head, size_t nextOffset, size_t dataOffset,
+                           int (*comparefunc)(const void *, const void *),
+                           void **tail) {
+  AlgoSortRun runs[128];
+  int count = 0;
+  void *rest = head;
+  while (rest != NULL || count > 1) {
+    if (rest != NULL) {
+      runs[count++] =
+          algo_sortNextRun(&rest, nextOffset, dataOffset, comparefunc);
+    }
+    while (count > 1) {
+      int n = count - 2;
+      if (rest == NULL) {
+        // All runs are known, merge everything.
+        if (n > 0 && runs[n - 1].length < runs[n + 1].length) {
+          n--;
+        }
+      } else if ((n > 0 && runs[n - 1].length <=
+                               runs[n].length + runs[n + 1].length) ||
+                 (n > 1 && runs[n - 2].length <=
+                               runs[n - 1].length + runs[n].length)) {
+        if (runs[n - 1].length < runs[n + 1].length) {
+          n--;
+        }
+      } else if (runs[n].length > runs[n + 1].length) {
+        break;
+      }
+      runs[n] = algo_sortMerge(runs[n], runs[n + 1], nextOffset, dataOffset,
+                               comparefunc);
+      if (n + 2 < count) {
+        runs[n + 1] = runs[n + 2];
+      }
+      count--;
+    }
+  }
+  *tail = runs[0].tail;
+  return runs[0].head;
+}
+
+// Sorts the list stably by the data of the nodes with a natural bottom-up
+// merge sort. Only the links change, the nodes keep their ids and data.
+int llist_sort(LinkedList *list,
+               int (*comparefunc)(const void *a, const void *b)) {
+  if (list == NULL || comparefunc == NULL) {
+    return 0;
+  } else if (list->front == NULL) {
+    return 1;
+  } else {
+    void *tail = NULL;
+    list->front = algo_sortList(list->front, offsetof(node, next),
+                                offsetof(node, data), comparefunc, &tail);
+    list->back = tail;
+    if (list->index != NULL) {
+      // The predecessors in the index changed with the order.
+      node *prev = NULL;
+      for (node *itrVar = list->front; itrVar != NULL; itrVar = itrVar->next) {
+        llist_indexSetPrev(list->index, itrVar, prev);
+        prev = itrVar;
+      }
+    }
+    return 1;
+  }
+}
+
+Stack *stack_create(void *data, size_t dataSize) {
+  return stack_createWithAllocator(data, dataSize, NULL);
+}
+
+// Creates a stack whose nodes are taken from the allocator.
+Stack *stack_createWithAllocator(void *data, size_t dataSize,
+                                 Allocator *allocator) {
+  if (data == NULL) {
+    return NULL;
+  }
+  void *payload = NULL;
+  Stack *stack = algo_allocNode(allocator, sizeof(Stack), dataSize, &payload,
+                                ALGO_INSTR_STACK);
+  if (stack == NULL) {
+    return NULL;
+  }
+  stack->dataSize = dataSize;
+  stack->next = NULL;
+  stack->allocator = allocator;
+
+  stack->data = payload;
+  memcpy(stack->data, data, dataSize);
+
+  return stack;
+}
+
+uint32_t stack_push(Stack **stack, void *data, size_t dataSize) {
+  if (stack == NULL || data == NULL || *stack == NULL) {
+    return 0;
+  } else {
+    Stack *temp =
+        stack_createWithAllocator(data, dataSize, (*stack)->allocator);
+    if (temp == NULL) {
+      return 0;
+    }
+    temp->next = *stack;
+    *stack = temp;
+
+    return 1;
+  }
+}
+Stack *stack_pop(Stack **stack) {
+  if (stack == NULL || *stack == NULL) {
+    return NULL;
+  } else {
+    Stack *temp = *stack;
+    *stack = (*stack)->next;
+    return temp;
+  }
+}
+
+// Frees a node returned by stack_pop together with its data.
+void stack_freeNode(Stack *node) {
+  if (node != NULL) {
+    algo_freeNode(node->allocator, node, sizeof(Stack), node->data,
+                  node->dataSize, ALGO_INSTR_STACK);
+  }
+}
+
+// Drops every node of the stack in O(1) by resetting its allocator.
+int stack_resetArena(Stack **stack) {
+  if (stack == NULL || *stack == NULL || (*stack)->allocator == NULL ||
+      (*stack)->allocator->reset == NULL) {
+    return 0;
+  } else {
+    (*stack)->allocator->reset((*stack)->allocator->context);
+    *stack = NULL;
+    return 1;
+  }
+}
+
+uint32_t stack_empty(Stack **stack) { return *stack == NULL; }
+
+Stack *stack_top(Stack *stack) {
+  if (stack == NULL) {
+    return NULL;
+  } else {
+    return stack;
+  }
+}
+
+// Create a new doubly linked list.
+DLinkedList *dllist_initialization(void *data, size_t dataSize) {
+  return dllist_initializationWithAllocator(data, dataSize, NULL);
+}
+
+// Create a new doubly linked list, its nodes are taken from the allocator.
+DLinkedList *dllist_initializationWithAllocator(void *data, size_t dataSize,
+                                                Allocator *allocator) {
+  if (data == NULL) {
+    return NULL;
+  } else {
+    // Allocates the space for the constant container of the list.
+    DLinkedList *list = malloc(sizeof(DLinkedList));
+    if (list == NULL) {
+      return NULL;
+    }
+    list->dataSize = dataSize;
+    list->size = 0;
+    list->head = NULL;
+    list->tail = NULL;
+    list->allocator = allocator;
+    if (!dllist_push(list, data, dataSize)) {
+      free(list);
+      return NULL;
+    }
+    return list;
+  }
+}
+
+// Adds a new element to the tail of the list. The nodes of a list all have
+// the data size of the list, so data has to hold at least that many bytes.
+int dllist_push(DLinkedList *list, void *data, size_t dataSize) {
+  if (list == NULL || data == NULL || dataSize < list->dataSize) {
+    return 0;
+  } else {
+    void *payload = NULL;
+    DLNode *node = algo_allocNode(list->allocator, sizeof(DLNode),
+                                  list->dataSize, &payload, ALGO_INSTR_DLLIST);
+    if (node == NULL) {
+      return 0;
+    }
+    node->data = payload;
+    node->prev = NULL;
+    node->next = NULL;
+    // Copy the data into the new node.
+    memcpy(node->data, data, list->dataSize);
+    if (list->size == 0) {
+      list->head = node;
+      list->tail = node;
+    } else {
+      // Set the next node after the current tail to be the new node.
+      list->tail->next = node;
+      // Set the pointer prev of the new node to point to the old tail.
+      node->prev = list->tail;
+      // Set the tail variable to the new node, as it is now the new tail.
+      list->tail = node;
+    }
+    // Increase the size of the list before returning to the caller.
+    list->size++;
+    return 1;
+  }
+}
+// Removes the element from the head.
+DLNode *dllist_pop(DLinkedList *list) {
+  // Error checking.
+  if (list == NULL || list->size == 0) {
+    return NULL;
+  } else {
+    // Sets the temporary variable to point to the head of the list.
+    DLNode *temp = list->head;
+    // Case 1: the list has two members.
+    if (list->size == 1) {
+      list->head = NULL;
+      list->tail = NULL;
+      // Case 2: the list has > 2 members.
+    } else {
+      list->head = temp->next;
+      list->head->prev = NULL;
+      temp->next = NULL;
+    }
+    list->size--;
+    return temp;
+  }
+}
+
+// Frees a node returned by dllist_pop together with its data.
+void dllist_freeNode(DLinkedList *list, DLNode *node) {
+  if (list != NULL && node != NULL) {
+    algo_freeNode(list->allocator, node, sizeof(DLNode), node->data,
+                  list->dataSize, ALGO_INSTR_DLLIST);
+  }
+}
+
+// Drops every node of the list in O(1) by resetting its allocator. No other
+// container may take nodes from the same allocator.
+int dllist_resetArena(DLinkedList *list) {
+  if (list == NULL || list->allocator == NULL ||
+      list->allocator->reset == NULL) {
+    return 0;
+  } else {
+    list->allocator->reset(list->allocator->context);
+    list->head = NULL;
+    list->tail = NULL;
+    list->size = 0;
+    return 1;
+  }
+}
+
+// Sorts the list stably by the data of the nodes with a natural bottom-up
+// merge sort. Only the links change.
+int dllist_sort(DLinkedList *list,
+                int (*comparefunc)(const void *a, const void *b)) {
+  if (list == NULL || comparefunc == NULL) {
+    return 0;
+  } else if (list->size == 0) {
+    return 1;
+  } else {
+    void *tail = NULL;
+    list->head = algo_sortList(list->head, offsetof(DLNode, next),
+                               offsetof(DLNode, data), comparefunc, &tail);
+    // The sort only follows next, restore the links back.
+    DLNode *prev = NULL;
+    for (DLNode *itrVar = list->head; itrVar != NULL; itrVar = itrVar->next) {
+      itrVar->prev = prev;
+      prev = itrVar;
+    }
+    list->tail = prev;
+    return 1;
+  }
+}
+
+static int algo_compareUint64(const void *a, const void *b) {
+  uint64_t first = *(const uint64_t *)a, second = *(const uint64_t *)b;
+  return (first > second) - (first < second);
+}
+
+// Sorts the list the old way: copies the data into an array, sorts it with
+// qsort and copies it back. Baseline of the sort benchmark.
+static void llist_sortByArray(LinkedList *list) {
+  uint64_t length = list->globalId + 1;
+  uint64_t *values = malloc(length * sizeof(uint64_t));
+  uint64_t i = 0;
+  for (node *itrVar = list->front; itrVar != NULL; itrVar = itrVar->next) {
+    values[i++] = *(uint64_t *)itrVar->data;
+  }
+  qsort(values, i, sizeof(uint64_t), algo_compareUint64);
+  i = 0;
+  for (node *itrVar = list->front; itrVar != NULL; itrVar = itrVar->next) {
+    *(uint64_t *)itrVar->data = values[i++];
+  }
+  free(values);
+}
+
+// Prints the time llist_sort, dllist_sort and the copy to an array with qsort
+// take for random and for nearly sorted lists of 1000 up to count integers.
+// The nearly sorted lists are in order except for one swap per 100 items.
+void llist_sortBenchmark(uint64_t count) {
+  printf("%-10s %-8s %-12s %-12s %-12s %-6s\n", "items", "input",
+         "llist_sort", "dllist_sort", "qsort copy", "check");
+  for (uint64_t items = 1000; items <= count; items *= 10) {
+    for (int nearly = 0; nearly < 2; nearly++) {
+      uint64_t *keys = malloc(items * sizeof(uint64_t));
+      uint64_t state = 1;
+      for (uint64_t i = 0; i < items; i++) {
+        keys[i] = nearly ? i : algo_random(&state) % items;
+      }
+      if (nearly) {
+        for (uint64_t i = 0; i < items / 100; i++) {
+          uint64_t a = algo_random(&state) % items;
+          uint64_t b = algo_random(&state) % items;
+          uint64_t temp = keys[a];
+          keys[a] = keys[b];
+          keys[b] = temp;
+        }
+      }
+      double times[3];
+      int sorted = 1;
+      for (int mode = 0; mode < 3; mode++) {
+        double start = 0;
+        if (mode == 1) {
+          DLinkedList *list = dllist_initialization(&keys[0], sizeof(uint64_t));
+          for (uint64_t i = 1; i < items; i++) {
+            dllist_push(list, &keys[i], sizeof(uint64_t));
+          }
+          start = algo_seconds();
+          dllist_sort(list, algo_compareUint64);
+          times[mode] = algo_seconds() - start;
+          for (DLNode *itrVar = list->head; itrVar->next != NULL;
+               itrVar = itrVar->next) {
+            sorted &= *(uint64_t *)itrVar->data <=
+                      *(uint64_t *)itrVar->next->data;
+          }
+          while (list->size) {
+            dllist_freeNode(list, dllist_pop(list));
+          }
+          free(list);
+        } else {
+          LinkedList *list = llist_createList(&keys[0], sizeof(uint64_t));
+          for (uint64_t i = 1; i < items; i++) {
+            llist_appendItem(list, &keys[i], sizeof(uint64_t));
+          }
+          start = algo_seconds();
+          if (mode == 0) {
+            llist_sort(list, algo_compareUint64);
+          } else {
+            llist_sortByArray(list);
+          }
+          times[mode] = algo_seconds() - start;
+          for (node *itrVar = list->front; itrVar->next != NULL;
+               itrVar = itrVar->next) {
+            sorted &= *(uint64_t *)itrVar->data <=
+                      *(uint64_t *)itrVar->next->data;
+          }
+          llist_deleteList(list, NULL);
+          free(list);
+        }
+      }
+      free(keys);
+      printf("%-10llu %-8s %-12.5f %-12.5f %-12.5f %-6s\n",
+             (unsigned long long)items, nearly ? "nearly" : "random",
+             times[0], times[1], times[2], sorted ? "ok" : "FAIL");
+    }
+  }
+}
+
+uint32_t dllist_size(DLinkedList *list) { return list->size; }
+
+int dllist_isEmpty(DLinkedList *list) { return dllist_size(list); }
+
+// Initializes a new queue with the data in the parameter.
+Queue *queue_initialize(void *data, size_t dataSize) {
+  return dllist_initialization(data, dataSize);
+}
+
+// Initializes a new queue whose nodes are taken from the allocator.
+Queue *queue_initializeWithAllocator(void *data, size_t dataSize,
+                                     Allocator *allocator) {
+  return dllist_initializationWithAllocator(data, dataSize, allocator);
+}
+
+// Enqueues a new item at the start of the queue.
+int queue_enqueue(Queue *queue, void *data, size_t dataSize) {
+  return dllist_push(queue, data, dataSize);
+}
+
+// Dequeues an item from the end of the queue.
+DLNode *queue_dequeue(Queue *queue) { return dllist_pop(queue); }
+
+// Frees a node returned by queue_dequeue together with its data.
+void queue_freeNode(Queue *queue, DLNode *node) {
+  dllist_freeNode(queue, node);
+}
+
+int queue_resetArena(Queue *queue) { return dllist_resetArena(queue); }
+
+// Bounded multi producer multi consumer queue:
+
+// Spins a few rounds before it gives the core away, waiting threads may need
+// the very thread they wait for to be scheduled.
+static void algo_backoff(uint32_t *spins) {
+  if (++*spins < 64) {
+#ifdef __x86_64__
+    __builtin_ia32_pause();
+#endif
+  } else {
+    sched_yield();
+  }
+}
+
+static atomic_uint_fast64_t *mpmc_sequence(MpmcQueue *queue,
+                                           uint64_t position) {
+  return (atomic_uint_fast64_t *)(queue->cells +
+                                  (position & queue->mask) * queue->cellSize);
+}
+
+static unsigned char *mpmc_data(MpmcQueue *queue, uint64_t position) {
+  return queue->cells + (position & queue->mask) * queue->cellSize +
+         sizeof(atomic_uint_fast64_t);
+}
+
+// Creates a queue for at least capacity elements of dataSize bytes, the
+// capacity gets rounded up to a power of two.
+MpmcQueue *mpmc_create(uint64_t capacity, size_t dataSize) {
+  if (dataSize == 0 || capacity == 0) {
+    return NULL;
+  } else {
+    uint64_t size = 2;
+    while (size < capacity) {
+      size *= 2;
+    }
+    MpmcQueue *queue = aligned_alloc(ALGO_CACHE_LINE, sizeof(MpmcQueue));
+    if (queue == NULL) {
+      return NULL;
+    }
+    queue->mask = size - 1;
+    queue->dataSize = dataSize;
+    queue->cellSize = (sizeof(atomic_uint_fast64_t) + dataSize + 7) & ~7ULL;
+    queue->cells = malloc(size * queue->cellSize);
+    if (queue->cells == NULL) {
+      free(queue);
+      return NULL;
+    }
+    // Cell i is ready for the enqueue of position i.
+    for (uint64_t i = 0; i < size; i++) {
+      atomic_init(mpmc_sequence(queue, i), i);
+    }
+    atomic_init(&queue->enqueuePosition, 0);
+    atomic_init(&queue->dequeuePosition, 0);
+    return queue;
+  }
+}
+
+// Copies the data into the queue, returns 0 if it is full.
+int mpmc_tryEnqueue(MpmcQueue *queue, const void *data) {
+  uint64_t position =
+      atomic_load_explicit(&queue->enqueuePosition, memory_order_relaxed);
+  for (;;) {
+    atomic_uint_fast64_t *sequence = mpmc_sequence(queue, position);
+    uint64_t ready = atomic_load_explicit(sequence, memory_order_acquire);
+    int64_t difference = (int64_t)(ready - position);
+    if (difference == 0) {
+      // The cell is free, try to claim the position.
+      if (atomic_compare_exchange_weak_explicit(
+              &queue->enqueuePosition, &position, position + 1,
+              memory_order_relaxed, memory_order_relaxed)) {
+        memcpy(mpmc_data(queue, position), data, queue->dataSize);
+        atomic_store_explicit(sequence, position + 1, memory_order_release);
+        return 1;
+      }
+    } else if (difference < 0) {
+      // The cell still holds the element of the previous round.
+      return 0;
+    } else {
+      position =
+          atomic_load_explicit(&queue->enqueuePosition, memory_order_relaxed);
+    }
+  }
+}
+
+// Copies the oldest element to out and removes it, returns 0 if the queue is
+// empty.
+int mpmc_tryDequeue(MpmcQueue *queue, void *out) {
+  uint64_t position =
+      atomic_load_explicit(&queue->dequeuePosition, memory_order_relaxed);
+  for (;;) {
+    atomic_uint_fast64_t *sequence = mpmc_sequence(queue, position);
+    uint64_t ready = atomic_load_explicit(sequence, memory_order_acquire);
+    int64_t difference = (int64_t)(ready - (position + 1));
+    if (difference == 0) {
+      if (atomic_compare_exchange_weak_explicit(
+              &queue->dequeuePosition, &position, position + 1,
+              memory_order_relaxed, memory_order_relaxed)) {
+        memcpy(out, mpmc_data(queue, position), queue->dataSize);
+        // Ready for the enqueue of the same cell in the next round.
+        atomic_store_explicit(sequence, position + queue->mask + 1,
+                              memory_order_release);
+        return 1;
+      }
+    } else if (difference < 0) {
+      return 0;
+    } else {
+      position =
+          atomic_load_explicit(&queue->dequeuePosition, memory_order_relaxed);
+    }
+  }
+}
+
+// Waits until there is room for the data.
+void mpmc_enqueue(MpmcQueue *queue, const void *data) {
+  uint32_t spins = 0;
+  while (!mpmc_tryEnqueue(queue, data)) {
+    algo_backoff(&spins);
+  }
+}
+
+// Waits until there is an element to dequeue.
+void mpmc_dequeue(MpmcQueue *queue, void *out) {
+  uint32_t spins = 0;
+  while (!mpmc_tryDequeue(queue, out)) {
+    algo_backoff(&spins);
+  }
+}
+
+// Enqueues up to count elements from the array data with a single claim of
+// the position counter and returns how many fit. The elements stay in order.
+uint64_t mpmc_enqueueN(MpmcQueue *queue, const void *data, uint64_t count) {
+  uint64_t position =
+      atomic_load_explicit(&queue->enqueuePosition, memory_order_relaxed);
+  for (;;) {
+    // Count the free cells from the position on.
+    uint64_t amount = 0;
+    while (amount < count &&
+           atomic_load_explicit(mpmc_sequence(queue, position + amount),
+                                memory_order_acquire) == position + amount) {
+      amount++;
+    }
+    if (amount == 0) {
+      uint64_t ready = atomic_load_explicit(mpmc_sequence(queue, position),
+                                            memory_order_acquire);
+      if ((int64_t)(ready - position) < 0) {
+        return 0;
+      }
+      position =
+          atomic_load_explicit(&queue->enqueuePosition, memory_order_relaxed);
+    } else if (atomic_compare_exchange_weak_explicit(
+                   &queue->enqueuePosition, &position, position + amount,
+                   memory_order_relaxed, memory_order_relaxed)) {
+      // The claimed cells can not be taken by anyone else anymore.
+      for (uint64_t i = 0; i < amount; i++) {
+        memcpy(mpmc_data(queue, position + i),
+               (const unsigned char *)data + i * queue->dataSize,
+               queue->dataSize);
+        atomic_store_explicit(mpmc_sequence(queue, position + i),
+                              position + i + 1, memory_order_release);
+      }
+      return amount;
+    }
+  }
+}
+
+// Dequeues up to count elements into the array out with a single claim of the
+// position counter and returns how many there were.
+uint64_t mpmc_dequeueN(MpmcQueue *queue, void *out, uint64_t count) {
+  uint64_t position =
+      atomic_load_explicit(&queue->dequeuePosition, memory_order_relaxed);
+  for (;;) {
+    uint64_t amount = 0;
+    while (amount < count &&
+           atomic_load_explicit(mpmc_sequence(queue, position + amount),
+                                memory_order_acquire) ==
+               position + amount + 1) {
+      amount++;
+    }
+    if (amount == 0) {
+      uint64_t ready = atomic_load_explicit(mpmc_sequence(queue, position),
+                                            memory_order_acquire);
+      if ((int64_t)(ready - (position + 1)) < 0) {
+        return 0;
+      }
+      position =
+          atomic_load_explicit(&queue->dequeuePosition, memory_order_relaxed);
+    } else if (atomic_compare_exchange_weak_explicit(
+                   &queue->dequeuePosition, &position, position + amount,
+                   memory_order_relaxed, memory_order_relaxed)) {
+      for (uint64_t i = 0; i < amount; i++) {
+        memcpy((unsigned char *)out + i * queue->dataSize,
+               mpmc_data(queue, position + i), queue->dataSize);
+        atomic_store_explicit(mpmc_sequence(queue, position + i),
+                              position + i + queue->mask + 1,
+                              memory_order_release);
+      }
+      return amount;
+    }
+  }
+}
+
+// Returns the amount of elements in the queue, it may be outdated as soon as
+// it is returned.
+uint64_t mpmc_size(MpmcQueue *queue) {
+  uint64_t dequeued = atomic_load(&queue->dequeuePosition);
+  uint64_t enqueued = atomic_load(&queue->enqueuePosition);
+  return (enqueued > dequeued) ? enqueued - dequeued : 0;
+}
+
+void mpmc_delete(MpmcQueue **queue) {
+  if (queue == NULL || *queue == NULL) {
+    return;
+  } else {
+    free((*queue)->cells);
+    free(*queue);
+    *queue = NULL;
+  }
+}
+
+// Shared state of the threads of the queue benchmark. Either queue or locked
+// is used.
+typedef struct {
+  MpmcQueue *queue;
+  Queue *locked;
+  pthread_mutex_t lock;
+  uint64_t itemsPerProducer;
+  uint64_t itemsPerConsumer;
+  atomic_uint_fast64_t sum;
+} MpmcBenchmarkJob;
+
+static void *mpmc_benchmarkProducer(void *argument) {
+  MpmcBenchmarkJob *job = argument;
+  for (uint64_t i = 1; i <= job->itemsPerProducer; i++) {
+    if (job->queue != NULL) {
+      mpmc_enqueue(job->queue, &i);
+    } else {
+      pthread_mutex_lock(&job->lock);
+      queue_enqueue(job->locked, &i, sizeof(i));
+      pthread_mutex_unlock(&job->lock);
+    }
+  }
+  return NULL;
+}
+
+static void *mpmc_benchmarkConsumer(void *argument) {
+  MpmcBenchmarkJob *job = argument;
+  uint64_t sum = 0;
+  for (uint64_t i = 0; i < job->itemsPerConsumer;) {
+    if (job->queue != NULL) {
+      uint64_t value = 0;
+      mpmc_dequeue(job->queue, &value);
+      sum += value;
+      i++;
+    } else {
+      pthread_mutex_lock(&job->lock);
+      DLNode *item = queue_dequeue(job->locked);
+      pthread_mutex_unlock(&job->lock);
+      if (item == NULL) {
+        sched_yield();
+      } else {
+        sum += *(uint64_t *)item->data;
+        // Released outside of the lock, malloc has its own.
+        queue_freeNode(job->locked, item);
+        i++;
+      }
+    }
+  }
+  atomic_fetch_add(&job->sum, sum);
+  return NULL;
+}
+
+// Prints the throughput of the lock-free queue and of a Queue behind a mutex
+// with 1, 2, ... up to maxThreads producers and as many consumers (0 for one
+// per core), which pass items integers through the queue.
+void mpmc_benchmark(uint64_t items, uint32_t maxThreads) {
+  maxThreads = algo_threadCount(maxThreads);
+  printf("%-10s %-16s %-16s %-6s\n", "threads", "lock-free M/s", "mutex M/s",
+         "check");
+  for (uint32_t threads = 1; threads <= maxThreads; threads++) {
+    double rates[2];
+    int correct = 1;
+    for (int locked = 0; locked < 2; locked++) {
+      MpmcBenchmarkJob job;
+      uint64_t value = 0;
+      job.itemsPerProducer = items / threads;
+      job.itemsPerConsumer = job.itemsPerProducer;
+      job.queue = locked ? NULL : mpmc_create(1024, sizeof(uint64_t));
+      job.locked = NULL;
+      if (locked) {
+        // The initial element of the Queue is not part of the benchmark.
+        job.locked = queue_initialize(&value, sizeof(value));
+        queue_freeNode(job.locked, queue_dequeue(job.locked));
+      }
+      pthread_mutex_init(&job.lock, NULL);
+      atomic_init(&job.sum, 0);
+      pthread_t *workers = malloc(2 * threads * sizeof(pthread_t));
+      double start = algo_seconds();
+      for (uint32_t i = 0; i < threads; i++) {
+        pthread_create(&workers[2 * i], NULL, mpmc_benchmarkConsumer, &job);
+        pthread_create(&workers[2 * i + 1], NULL, mpmc_benchmarkProducer,
+                       &job);
+      }
+      for (uint32_t i = 0; i < 2 * threads; i++) {
+        pthread_join(workers[i], NULL);
+      }
+      double time = algo_seconds() - start;
+      uint64_t perProducer = job.itemsPerProducer;
+      correct &= atomic_load(&job.sum) ==
+                 threads * (perProducer * (perProducer + 1) / 2);
+      rates[locked] = (double)(threads * perProducer) / time / 1e6;
+      free(workers);
+      pthread_mutex_destroy(&job.lock);
+      mpmc_delete(&job.queue);
+      free(job.locked);
+    }
+    printf("%-10u %-16.2f %-16.2f %-6s\n", threads, rates[0], rates[1],
+           correct ? "ok" : "FAIL");
+  }
+}
+
+// Single producer single consumer queue:
+
+// Creates a queue for at least capacity elements of dataSize bytes, the
+// capacity gets rounded up to a power of two.
+SpscQueue *spsc_create(uint64_t capacity, size_t dataSize) {
+  if (dataSize == 0 || capacity == 0) {
+    return NULL;
+  } else {
+    uint64_t size = 2;
+    while (size < capacity) {
+      size *= 2;
+    }
+    SpscQueue *queue = aligned_alloc(ALGO_CACHE_LINE, sizeof(SpscQueue));
+    if (queue == NULL) {
+      return NULL;
+    }
+    queue->mask = size - 1;
+    queue->dataSize = dataSize;
+    queue->data = malloc(size * dataSize);
+    if (queue->data == NULL) {
+      free(queue);
+      return NULL;
+    }
+    atomic_init(&queue->tail, 0);
+    atomic_init(&queue->head, 0);
+    queue->cachedHead = 0;
+    queue->cachedTail = 0;
+    return queue;
+  }
+}
+
+// Returns how many elements the producer can write from the tail on. The
+// head of the consumer is only loaded if the cached one says there are less
+// than wanted.
+static uint64_t spsc_freeSlots(SpscQueue *queue, uint64_t tail,
+                               uint64_t wanted) {
+  uint64_t capacity = queue->mask + 1;
+  if (capacity - (tail - queue->cachedHead) < wanted) {
+    queue->cachedHead =
+        atomic_load_explicit(&queue->head, memory_order_acquire);
+  }
+  return capacity - (tail - queue->cachedHead);
+}
+
+// Returns how many elements the consumer can read from the head on.
+static uint64_t spsc_usedSlots(SpscQueue *queue, uint64_t head,
+                               uint64_t wanted) {
+  if (queue->cachedTail - head < wanted) {
+    queue->cachedTail =
+        atomic_load_explicit(&queue->tail, memory_order_acquire);
+  }
+  return queue->cachedTail - head;
+}
+
+// Copies the data into the queue, returns 0 if it is full. Only the producer
+// thread may call it.
+int spsc_tryEnqueue(SpscQueue *queue, const void *data) {
+  uint64_t tail = atomic_load_explicit(&queue->tail, memory_order_relaxed);
+  if (spsc_freeSlots(queue, tail, 1) == 0) {
+    return 0;
+  } else {
+    memcpy(queue->data + (tail & queue->mask) * queue->dataSize, data,
+           queue->dataSize);
+    atomic_store_explicit(&queue->tail, tail + 1, memory_order_release);
+    return 1;
+  }
+}
+
+// Copies the oldest element to out and removes it, returns 0 if the queue is
+// empty. Only the consumer thread may call it.
+int spsc_tryDequeue(SpscQueue *queue, void *out) {
+  uint64_t head = atomic_load_explicit(&queue->head, memory_order_relaxed);
+  if (spsc_usedSlots(queue, head, 1) == 0) {
+    return 0;
+  } else {
+    memcpy(out, queue->data + (head & queue->mask) * queue->dataSize,
+           queue->dataSize);
+    atomic_store_explicit(&queue->head, head + 1, memory_order_release);
+    return 1;
+  }
+}
+
+// Waits until there is room for the data.
+void spsc_enqueue(SpscQueue *queue, const void *data) {
+  uint32_t spins = 0;
+  while (!spsc_tryEnqueue(queue, data)) {
+    algo_backoff(&spins);
+  }
+}
+
+// Waits until there is an element to dequeue.
+void spsc_dequeue(SpscQueue *queue, void *out) {
+  uint32_t spins = 0;
+  while (!spsc_tryDequeue(queue, out)) {
+    algo_backoff(&spins);
+  }
+}
+
+// Enqueues up to count elements from the array data and publishes them with
+// a single store, returns how many fit.
+uint64_t spsc_enqueueN(SpscQueue *queue, const void *data, uint64_t count) {
+  uint64_t tail = atomic_load_explicit(&queue->tail, memory_order_relaxed);
+  uint64_t amount = spsc_freeSlots(queue, tail, count);
+  if (amount > count) {
+    amount = count;
+  }
+  // The range may wrap around the end of the buffer.
+  uint64_t start = tail & queue->mask;
+  uint64_t first = queue->mask + 1 - start;
+  if (first > amount) {
+    first = amount;
+  }
+  memcpy(queue->data + start * queue->dataSize, data,
+         first * queue->dataSize);
+  memcpy(queue->data, (const unsigned char *)data + first * queue->dataSize,
+         (amount - first) * queue->dataSize);
+  atomic_store_explicit(&queue->tail, tail + amount, memory_order_release);
+  return amount;
+}
+
+// Dequeues up to count elements into the array out and releases their slots
+// with a single store, returns how many there were.
+uint64_t spsc_dequeueN(SpscQueue *queue, void *out, uint64_t count) {
+  uint64_t head = atomic_load_explicit(&queue->head, memory_order_relaxed);
+  uint64_t amount = spsc_usedSlots(queue, head, count);
+  if (amount > count) {
+    amount = count;
+  }
+  uint64_t start = head & queue->mask;
+  uint64_t first = queue->mask + 1 - start;
+  if (first > amount) {
+    first = amount;
+  }
+  memcpy(out, queue->data + start * queue->dataSize, first * queue->dataSize);
+  memcpy((unsigned char *)out + first * queue->dataSize, queue->data,
+         (amount - first) * queue->dataSize);
+  atomic_store_explicit(&queue->head, head + amount, memory_order_release);
+  return amount;
+}
+
+// Returns the free slots from the tail on to be filled in place and sets count
+// to how many of them are contiguous, at most the count that was passed. The
+// elements become visible with spsc_publish.
+void *spsc_reserve(SpscQueue *queue, uint64_t *count) {
+  uint64_t tail = atomic_load_explicit(&queue->tail, memory_order_relaxed);
+  uint64_t amount = spsc_freeSlots(queue, tail, *count);
+  uint64_t start = tail & queue->mask;
+  if (amount > queue->mask + 1 - start) {
+    amount = queue->mask + 1 - start;
+  }
+  if (amount < *count) {
+    *count = amount;
+  }
+  return queue->data + start * queue->dataSize;
+}
+
+// Makes count elements written after spsc_reserve visible to the consumer.
+void spsc_publish(SpscQueue *queue, uint64_t count) {
+  uint64_t tail = atomic_load_explicit(&queue->tail, memory_order_relaxed);
+  atomic_store_explicit(&queue->tail, tail + count, memory_order_release);
+}
+
+// Returns the oldest elements to be read in place and sets count to how many
+// of them are contiguous, at most the count that was passed. They stay in the
+// queue until spsc_consume.
+void *spsc_peek(SpscQueue *queue, uint64_t *count) {
+  uint64_t head = atomic_load_explicit(&queue->head, memory_order_relaxed);
+  uint64_t amount = spsc_usedSlots(queue, head, *count);
+  uint64_t start = head & queue->mask;
+  if (amount > queue->mask + 1 - start) {
+    amount = queue->mask + 1 - start;
+  }
+  if (amount < *count) {
+    *count = amount;
+  }
+  return queue->data + start * queue->dataSize;
+}
+
+// Releases the slots of count elements read after spsc_peek to the producer.
+void spsc_consume(SpscQueue *queue, uint64_t count) {
+  uint64_t head = atomic_load_explicit(&queue->head, memory_order_relaxed);
+  atomic_store_explicit(&queue->head, head + count, memory_order_release);
+}
+
+// Returns the amount of elements in the queue, it may be outdated as soon as
+// it is returned.
+uint64_t spsc_size(SpscQueue *queue) {
+  uint64_t head = atomic_load(&queue->head);
+  uint64_t tail = atomic_load(&queue->tail);
+  return (tail > head) ? tail - head : 0;
+}
+
+void spsc_delete(SpscQueue **queue) {
+  if (queue == NULL || *queue == NULL) {
+    return;
+  } else {
+    free((*queue)->data);
+    free(*queue);
+    *queue = NULL;
+  }
+}
+
+// Shared state of the threads of the SPSC benchmark. The consumer sends every
+// item back through reply when pingPong is set, otherwise it adds them up.
+typedef struct {
+  SpscQueue *queue;
+  SpscQueue *reply;
+  uint64_t items;
+  uint64_t batch;
+  int pingPong;
+  uint64_t sum;
+} SpscBenchmarkJob;
+
+static void *spsc_benchmarkConsumer(void *argument) {
+  SpscBenchmarkJob *job = argument;
+  uint64_t sum = 0;
+  uint64_t values[256];
+  for (uint64_t i = 0; i < job->items;) {
+    if (job->batch > 1) {
+      uint32_t spins = 0;
+      uint64_t amount;
+      while ((amount = spsc_dequeueN(job->queue, values, job->batch)) == 0) {
+        algo_backoff(&spins);
+      }
+      for (uint64_t j = 0; j < amount; j++) {
+        sum += values[j];
+      }
+      i += amount;
+    } else {
+      spsc_dequeue(job->queue, values);
+      if (job->pingPong) {
+        spsc_enqueue(job->reply, values);
+      }
+      sum += values[0];
+      i++;
+    }
+  }
+  job->sum = sum;
+  return NULL;
+}
+
+// Prints the throughput of the queue for items integers passed one by one and
+// in batches, next to the MPMC queue with one thread per side, and the round
+// trip latency of a message that is sent back through a second queue.
+void spsc_benchmark(uint64_t items) {
+  const uint64_t batches[] = {1, 16, 256};
+  uint64_t expected = items * (items + 1) / 2;
+  uint64_t values[256];
+  printf("%-12s %-8s %-12s %-12s %-6s\n", "queue", "batch", "ns/op",
+         "M msgs/s", "check");
+  for (int i = 0; i < 4; i++) {
+    SpscBenchmarkJob job = {0};
+    job.queue = spsc_create(1024, sizeof(uint64_t));
+    job.items = items;
+    job.batch = (i < 3) ? batches[i] : 1;
+    MpmcQueue *mpmc = (i == 3) ? mpmc_create(1024, sizeof(uint64_t)) : NULL;
+    uint64_t sum = 0;
+    pthread_t consumer;
+    double start = algo_seconds();
+    if (mpmc != NULL) {
+      MpmcBenchmarkJob mpmcJob;
+      mpmcJob.queue = mpmc;
+      mpmcJob.locked = NULL;
+      mpmcJob.itemsPerProducer = items;
+      mpmcJob.itemsPerConsumer = items;
+      atomic_init(&mpmcJob.sum, 0);
+      pthread_create(&consumer, NULL, mpmc_benchmarkConsumer, &mpmcJob);
+      mpmc_benchmarkProducer(&mpmcJob);
+      pthread_join(consumer, NULL);
+      sum = atomic_load(&mpmcJob.sum);
+    } else {
+      pthread_create(&consumer, NULL, spsc_benchmarkConsumer, &job);
+      for (uint64_t next = 1; next <= items;) {
+        uint64_t amount = items - next + 1;
+        if (amount > job.batch) {
+          amount = job.batch;
+        }
+        for (uint64_t j = 0; j < amount; j++) {
+          values[j] = next + j;
+        }
+        uint32_t spins = 0;
+        uint64_t sent;
+        while ((sent = spsc_enqueueN(job.queue, values, amount)) == 0) {
+          algo_backoff(&spins);
+        }
+        next += sent;
+      }
+      pthread_join(consumer, NULL);
+      sum = job.sum;
+    }
+    double time = algo_seconds() - start;
+    printf("%-12s %-8llu %-12.2f %-12.2f %-6s\n",
+           mpmc ? "MpmcQueue" : "SpscQueue", (unsigned long long)job.batch,
+           time * 1e9 / (double)items, (double)items / time / 1e6,
+           (sum == expected) ? "ok" : "FAIL");
+    spsc_delete(&job.queue);
+    mpmc_delete(&mpmc);
+  }
+
+  // Round trips wait for the other thread each time, so there are fewer.
+  SpscBenchmarkJob job = {0};
+  job.queue = spsc_create(64, sizeof(uint64_t));
+  job.reply = spsc_create(64, sizeof(uint64_t));
+  job.items = items / 100 + 1;
+  job.batch = 1;
+  job.pingPong = 1;
+  pthread_t consumer;
+  pthread_create(&consumer, NULL, spsc_benchmarkConsumer, &job);
+  double start = algo_seconds();
+  for (uint64_t i = 1; i <= job.items; i++) {
+    spsc_enqueue(job.queue, &i);
+    spsc_dequeue(job.reply, values);
+  }
+  double time = algo_seconds() - start;
+  pthread_join(consumer, NULL);
+  printf("round trip: %.2f ns\n", time * 1e9 / (double)job.items);
+  spsc_delete(&job.queue);
+  spsc_delete(&job.reply);
+}
+
+// Lock-free stack:
+
+// Marks an elimination slot whose offer was taken by a pop.
+#define TSTACK_TAKEN UINT64_MAX
+// Rounds a push waits in the elimination array for a pop.
+#define TSTACK_ELIMINATION_SPINS 64
+#define TSTACK_INDEX_MASK 0xFFFFFFFFULL
+
+// Node with the index ref - 1, ref 0 stands for no node. A node is the index
+// of the next one followed by the data words.
+static atomic_uint_fast64_t *tstack_node(TreiberStack *stack, uint64_t ref) {
+  uint64_t index = ref - 1;
+  unsigned char *chunk = atomic_load_explicit(
+      &stack->chunks[index / TSTACK_CHUNK_NODES], memory_order_acquire);
+  return (atomic_uint_fast64_t *)(chunk + (index % TSTACK_CHUNK_NODES) *
+                                              stack->nodeSize);
+}
+
+static uint64_t tstack_pack(uint64_t head, uint64_t ref) {
+  return (((head >> 32) + 1) << 32) | ref;
+}
+
+// Pops a node off the list with the head and returns its ref, 0 if empty.
+static uint64_t tstack_popNode(TreiberStack *stack,
+                               atomic_uint_fast64_t *head) {
+  uint64_t old = atomic_load_explicit(head, memory_order_acquire);
+  for (;;) {
+    uint64_t ref = old & TSTACK_INDEX_MASK;
+    if (ref == 0) {
+      return 0;
+    }
+    // The node may get popped and reused by another thread meanwhile, then
+    // next is garbage but the tag makes the exchange fail.
+    uint64_t next =
+        atomic_load_explicit(tstack_node(stack, ref), memory_order_relaxed);
+    if (atomic_compare_exchange_weak_explicit(head, &old,
+                                              tstack_pack(old, next),
+                                              memory_order_acquire,
+                                              memory_order_acquire)) {
+      return ref;
+    }
+  }
+}
+
+// Makes one attempt to push the node onto the list with the head.
+static int tstack_tryPushNode(TreiberStack *stack, atomic_uint_fast64_t *head,
+                              uint64_t ref) {
+  uint64_t old = atomic_load_explicit(head, memory_order_relaxed);
+  atomic_store_explicit(tstack_node(stack, ref), old & TSTACK_INDEX_MASK,
+                        memory_order_relaxed);
+  return atomic_compare_exchange_strong_explicit(
+      head, &old, tstack_pack(old, ref), memory_order_release,
+      memory_order_relaxed);
+}
+
+// Takes a node from the free list or from the pool, 0 if the pool is full.
+static uint64_t tstack_allocNode(TreiberStack *stack) {
+  uint64_t ref = tstack_popNode(stack, &stack->freeHead);
+  if (ref != 0) {
+    return ref;
+  }
+  uint64_t index = atomic_fetch_add(&stack->nodeCount, 1);
+  if (index >= (uint64_t)TSTACK_MAX_CHUNKS * TSTACK_CHUNK_NODES) {
+    return 0;
+  }
+  _Atomic(unsigned char *) *slot = &stack->chunks[index / TSTACK_CHUNK_NODES];
+  if (atomic_load_explicit(slot, memory_order_acquire) == NULL) {
+    // Every thread that gets an index in a missing chunk tries to install
+    // one, the losers free theirs.
+    unsigned char *chunk = calloc(TSTACK_CHUNK_NODES, stack->nodeSize);
+    unsigned char *expected = NULL;
+    if (chunk == NULL) {
+      return 0;
+    }
+    if (!atomic_compare_exchange_strong(slot, &expected, chunk)) {
+      free(chunk);
+    }
+  }
+  return index + 1;
+}
+
+static void tstack_freeNode(TreiberStack *stack, uint64_t ref) {
+  while (!tstack_tryPushNode(stack, &stack->freeHead, ref)) {
+  }
+}
+
+// Copies the data into the words of the node.
+static void tstack_write(TreiberStack *stack, uint64_t ref, const void *data) {
+  atomic_uint_fast64_t *words = tstack_node(stack, ref) + 1;
+  for (size_t i = 0; i < stack->words; i++) {
+    uint64_t word = 0;
+    size_t offset = i * sizeof(uint64_t);
+    size_t length = stack->dataSize - offset;
+    memcpy(&word, (const unsigned char *)data + offset,
+           length < sizeof(uint64_t) ? length : sizeof(uint64_t));
+    atomic_store_explicit(&words[i], word, memory_order_relaxed);
+  }
+}
+
+static void tstack_read(TreiberStack *stack, uint64_t ref, void *out) {
+  atomic_uint_fast64_t *words = tstack_node(stack, ref) + 1;
+  for (size_t i = 0; i < stack->words; i++) {
+    uint64_t word = atomic_load_explicit(&words[i], memory_order_relaxed);
+    size_t offset = i * sizeof(uint64_t);
+    size_t length = stack->dataSize - offset;
+    memcpy((unsigned char *)out + offset, &word,
+           length < sizeof(uint64_t) ? length : sizeof(uint64_t));
+  }
+}
+
+// Picks an elimination slot at random, so the threads spread over the array.
+static TreiberSlot *tstack_slot(TreiberStack *stack) {
+  static _Thread_local uint64_t state = 0;
+  if (state == 0) {
+    state = (uint64_t)(uintptr_t)&state | 1;
+  }
+  return &stack->elimination[algo_random(&state) % TSTACK_ELIMINATION_SLOTS];
+}
+
+// Offers the node of a push to the pops for a short time. Returns 1 if a pop
+// took it, a push and a pop that meet cancel out without touching the head.
+static int tstack_eliminatePush(TreiberStack *stack, uint64_t ref) {
+  TreiberSlot *slot = tstack_slot(stack);
+  uint64_t expected = 0;
+  if (!atomic_compare_exchange_strong_explicit(&slot->offer, &expected, ref,
+                                               memory_order_release,
+                                               memory_order_relaxed)) {
+    return 0;
+  }
+  uint32_t spins = 0;
+  while (spins < TSTACK_ELIMINATION_SPINS &&
+         atomic_load_explicit(&slot->offer, memory_order_relaxed) == ref) {
+    algo_backoff(&spins);
+  }
+  expected = ref;
+  if (atomic_compare_exchange_strong(&slot->offer, &expected, 0)) {
+    // Withdrawn, nobody came.
+    return 0;
+  }
+  atomic_store_explicit(&slot->offer, 0, memory_order_release);
+  return 1;
+}
+
+// Takes the node of a waiting push from the elimination array, if there is
+// one, and copies its data to out.
+static int tstack_eliminatePop(TreiberStack *stack, void *out) {
+  TreiberSlot *slot = tstack_slot(stack);
+  uint64_t ref = atomic_load_explicit(&slot->offer, memory_order_relaxed);
+  if (ref == 0 || ref == TSTACK_TAKEN ||
+      !atomic_compare_exchange_strong_explicit(&slot->offer, &ref, TSTACK_TAKEN,
+                                               memory_order_acquire,
+                                               memory_order_relaxed)) {
+    return 0;
+  }
+  tstack_read(stack, ref, out);
+  tstack_freeNode(stack, ref);
+  return 1;
+}
+
+// Creates an empty stack for elements of dataSize bytes.
+TreiberStack *tstack_create(size_t dataSize) {
+  if (dataSize == 0) {
+    return NULL;
+  } else {
+    TreiberStack *stack = aligned_alloc(ALGO_CACHE_LINE, sizeof(TreiberStack));
+    if (stack == NULL) {
+      return NULL;
+    }
+    stack->chunks = calloc(TSTACK_MAX_CHUNKS, sizeof(*stack->chunks));
+    if (stack->chunks == NULL) {
+      free(stack);
+      return NULL;
+    }
+    atomic_init(&stack->head, 0);
+    atomic_init(&stack->freeHead, 0);
+    atomic_init(&stack->nodeCount, 0);
+    for (int i = 0; i < TSTACK_ELIMINATION_SLOTS; i++) {
+      atomic_init(&stack->elimination[i].offer, 0);
+    }
+    stack->dataSize = dataSize;
+    stack->words = (dataSize + sizeof(uint64_t) - 1) / sizeof(uint64_t);
+    stack->nodeSize = (stack->words + 1) * sizeof(uint64_t);
+    stack->useElimination = 1;
+    return stack;
+  }
+}
+
+// Copies the data onto the stack, returns 0 if the node pool is exhausted.
+int tstack_push(TreiberStack *stack, const void *data) {
+  uint64_t ref = tstack_allocNode(stack);
+  if (ref == 0) {
+    return 0;
+  }
+  tstack_write(stack, ref, data);
+  for (;;) {
+    if (tstack_tryPushNode(stack, &stack->head, ref)) {
+      return 1;
+    }
+    // Lost the race against another thread.
+    if (stack->useElimination && tstack_eliminatePush(stack, ref)) {
+      return 1;
+    }
+  }
+}
+
+// Removes the top element and copies it to out, returns 0 if the stack is
+// empty.
+int tstack_pop(TreiberStack *stack, void *out) {
+  uint64_t old = atomic_load_explicit(&stack->head, memory_order_acquire);
+  for (;;) {
+    uint64_t ref = old & TSTACK_INDEX_MASK;
+    if (ref == 0) {
+      return 0;
+    }
+    uint64_t next =
+        atomic_load_explicit(tstack_node(stack, ref), memory_order_relaxed);
+    if (atomic_compare_exchange_weak_explicit(&stack->head, &old,
+                                              tstack_pack(old, next),
+                                              memory_order_acquire,
+                                              memory_order_acquire)) {
+      tstack_read(stack, ref, out);
+      tstack_freeNode(stack, ref);
+      return 1;
+    }
+    if (stack->useElimination && tstack_eliminatePop(stack, out)) {
+      return 1;
+    }
+    old = atomic_load_explicit(&stack->head, memory_order_acquire);
+  }
+}
+
+// Copies the top element to out without removing it, returns 0 if the stack
+// is empty. The copy is only kept if the head did not change while it was
+// taken, otherwise the node may have been reused.
+int tstack_top(TreiberStack *stack, void *out) {
+  for (;;) {
+    uint64_t old = atomic_load_explicit(&stack->head, memory_order_acquire);
+    if ((old & TSTACK_INDEX_MASK) == 0) {
+      return 0;
+    }
+    tstack_read(stack, old & TSTACK_INDEX_MASK, out);
+    atomic_thread_fence(memory_order_acquire);
+    if (atomic_load_explicit(&stack->head, memory_order_relaxed) == old) {
+      return 1;
+    }
+  }
+}
+
+int tstack_empty(TreiberStack *stack) {
+  return (atomic_load(&stack->head) & TSTACK_INDEX_MASK) == 0;
+}
+
+void tstack_delete(TreiberStack **stack) {
+  if (stack == NULL || *stack == NULL) {
+    return;
+  } else {
+    for (int i = 0; i < TSTACK_MAX_CHUNKS; i++) {
+      free(atomic_load(&(*stack)->chunks[i]));
+    }
+    free((*stack)->chunks);
+    free(*stack);
+    *stack = NULL;
+  }
+}
+
+// Shared state of the threads of the stack benchmark. Either stack or locked
+// is used.
+typedef struct {
+  TreiberStack *stack;
+  Stack *locked;
+  pthread_mutex_t lock;
+  uint64_t pairs;
+  atomic_uint_fast64_t sum;
+} TstackBenchmarkJob;
+
+static void *tstack_benchmarkWorker(void *argument) {
+  TstackBenchmarkJob *job = argument;
+  uint64_t sum = 0;
+  for (uint64_t i = 1; i <= job->pairs; i++) {
+    uint64_t value = 0;
+    if (job->stack != NULL) {
+      tstack_push(job->stack, &i);
+      tstack_pop(job->stack, &value);
+    } else {
+      pthread_mutex_lock(&job->lock);
+      stack_push(&job->locked, &i, sizeof(i));
+      pthread_mutex_unlock(&job->lock);
+      pthread_mutex_lock(&job->lock);
+      Stack *item = stack_pop(&job->locked);
+      pthread_mutex_unlock(&job->lock);
+      value = *(uint64_t *)item->data;
+      stack_freeNode(item);
+    }
+    sum += value;
+  }
+  atomic_fetch_add(&job->sum, sum);
+  return NULL;
+}
+
+// Prints the throughput in million operations per second of the lock-free
+// stack with and without elimination and of a Stack behind a mutex, with 1,
+// 2, ... up to maxThreads threads (0 for one per core). Every thread does
+// operations / threads pairs of a push and a pop.
+void tstack_benchmark(uint64_t operations, uint32_t maxThreads) {
+  maxThreads = algo_threadCount(maxThreads);
+  printf("%-10s %-14s %-14s %-14s %-6s\n", "threads", "lock-free",
+         "elimination", "mutex", "check");
+  for (uint32_t threads = 1; threads <= maxThreads; threads++) {
+    double rates[3];
+    int correct = 1;
+    for (int mode = 0; mode < 3; mode++) {
+      TstackBenchmarkJob job;
+      uint64_t sentinel = 0;
+      job.pairs = operations / threads;
+      job.stack = (mode < 2) ? tstack_create(sizeof(uint64_t)) : NULL;
+      job.locked = NULL;
+      if (mode < 2) {
+        job.stack->useElimination = mode;
+      } else {
+        // stack_push needs a stack to push onto.
+        job.locked = stack_create(&sentinel, sizeof(sentinel));
+      }
+      pthread_mutex_init(&job.lock, NULL);
+      atomic_init(&job.sum, 0);
+      pthread_t *workers = malloc(threads * sizeof(pthread_t));
+      double start = algo_seconds();
+      for (uint32_t i = 0; i < threads; i++) {
+        pthread_create(&workers[i], NULL, tstack_benchmarkWorker, &job);
+      }
+      for (uint32_t i = 0; i < threads; i++) {
+        pthread_join(workers[i], NULL);
+      }
+      double time = algo_seconds() - start;
+      correct &= atomic_load(&job.sum) ==
+                 threads * (job.pairs * (job.pairs + 1) / 2);
+      rates[mode] = (double)(2 * threads * job.pairs) / time / 1e6;
+      free(workers);
+      pthread_mutex_destroy(&job.lock);
+      tstack_delete(&job.stack);
+      if (job.locked != NULL) {
+        stack_freeNode(job.locked);
+      }
+    }
+    printf("%-10u %-14.2f %-14.2f %-14.2f %-6s\n", threads, rates[0],
+           rates[1], rates[2], correct ? "ok" : "FAIL");
+  }
+}
+
+// Prints the time a queue and a linked list need for count items with malloc
+// and with a pool allocator. The queue cycles the items through a window of
+// 1024 entries, the list is built up and torn down at once. The malloc list
+// runs last, the pages its teardown returns to the system would otherwise slow
+// down whatever runs next.
+void pool_benchmark(uint64_t count) {
+  double times[2][2];
+  int64_t sums[2] = {0, 0};
+  uint64_t value = 0;
+  PoolAllocator *pool = pool_create(64, 4096);
+
+  for (int mode = 0; mode < 2; mode++) {
+    Allocator *allocator = mode ? &pool->allocator : NULL;
+    double start = algo_seconds();
+    Queue *queue =
+        queue_initializeWithAllocator(&value, sizeof(value), allocator);
+    for (uint64_t i = 1; i < count; i++) {
+      queue_enqueue(queue, &i, sizeof(i));
+      if (i >= 1024) {
+        DLNode *item = queue_dequeue(queue);
+        sums[mode] += *(uint64_t *)item->data;
+        queue_freeNode(queue, item);
+      }
+    }
+    while (queue->size) {
+      DLNode *item = queue_dequeue(queue);
+      sums[mode] += *(uint64_t *)item->data;
+      queue_freeNode(queue, item);
+    }
+    times[mode][0] = algo_seconds() - start;
+    free(queue);
+  }
+  pool_reset(pool);
+
+  for (int mode = 1; mode >= 0; mode--) {
+    Allocator *allocator = mode ? &pool->allocator : NULL;
+    double start = algo_seconds();
+    LinkedList *list =
+        llist_createListWithAllocator(&value, sizeof(value), allocator);
+    for (uint64_t i = 1; i < count; i++) {
+      llist_appendItem(list, &i, sizeof(i));
+    }
+    if (mode) {
+      llist_resetArena(list);
+    } else {
+      llist_deleteList(list, NULL);
+    }
+    times[mode][1] = algo_seconds() - start;
+    free(list);
+  }
+  pool_delete(&pool);
+
+  printf("%-10s %-12s %-12s %-6s\n", "allocator", "queue", "list", "check");
+  const char *names[] = {"malloc", "pool"};
+  for (int i = 0; i < 2; i++) {
+    printf("%-10s %-12.5f %-12.5f %-6s\n", names[i], times[i][0], times[i][1],
+           (sums[i] == sums[0]) ? "ok" : "FAIL");
+  }
+}
+
+// Lists and stack with inline data:
+
+// Allocates size bytes from the allocator, or from malloc without one.
+static void *algo_allocBlock(Allocator *allocator, size_t size) {
+  if (allocator != NULL) {
+    return allocator->alloc(allocator->context, size);
+  } else {
+    return malloc(size);
+  }
+}
+
+static void algo_freeBlock(Allocator *allocator, void *block, size_t size) {
+  if (allocator != NULL) {
+    allocator->free(allocator->context, block, size);
+  } else {
+    free(block);
+  }
+}
+
+// Creates an empty list for items of dataSize bytes. The allocator may be
+// NULL.
+InlineLinkedList *illist_create(size_t dataSize, Allocator *allocator) {
+  if (dataSize == 0) {
+    return NULL;
+  } else {
+    InlineLinkedList *list = calloc(1, sizeof(InlineLinkedList));
+    if (list == NULL) {
+      return NULL;
+    }
+    list->dataSize = dataSize;
+    list->allocator = allocator;
+    return list;
+  }
+}
+
+// Copies the data into a new node at the back and returns its id, or
+// UINT64_MAX if the node can not be allocated.
+uint64_t illist_appendItem(InlineLinkedList *list, const void *data) {
+  if (list == NULL || data == NULL) {
+    return UINT64_MAX;
+  }
+  InlineNode *item =
+      algo_allocBlock(list->allocator, sizeof(InlineNode) + list->dataSize);
+  if (item == NULL) {
+    return UINT64_MAX;
+  }
+  item->id = (list->front == NULL) ? (list->globalId = 0) : ++list->globalId;
+  item->next = NULL;
+  memcpy(item->data, data, list->dataSize);
+  if (list->front == NULL) {
+    list->front = item;
+  } else {
+    list->back->next = item;
+  }
+  list->back = item;
+  list->size++;
+  return item->id;
+}
+
+InlineNode *illist_findItem(InlineLinkedList *list, uint64_t id) {
+  if (list == NULL) {
+    return NULL;
+  }
+  InlineNode *itrVar = list->front;
+  while (itrVar != NULL && itrVar->id != id) {
+    itrVar = itrVar->next;
+  }
+  return itrVar;
+}
+
+// Unlinks and frees the node with the id, returns 0 if there is none.
+int illist_deleteItem(InlineLinkedList *list, uint64_t id) {
+  if (list == NULL) {
+    return 0;
+  }
+  InlineNode *prev = NULL, *itrVar = list->front;
+  while (itrVar != NULL && itrVar->id != id) {
+    prev = itrVar;
+    itrVar = itrVar->next;
+  }
+  if (itrVar == NULL) {
+    return 0;
+  } else {
+    if (prev == NULL) {
+      list->front = itrVar->next;
+    } else {
+      prev->next = itrVar->next;
+    }
+    if (list->back == itrVar) {
+      list->back = prev;
+    }
+    algo_freeBlock(list->allocator, itrVar,
+                   sizeof(InlineNode) + list->dataSize);
+    list->size--;
+    return 1;
+  }
+}
+
+void illist_delete(InlineLinkedList **list) {
+  if (list == NULL || *list == NULL) {
+    return;
+  } else {
+    InlineNode *itrVar = (*list)->front;
+    while (itrVar != NULL) {
+      InlineNode *next = itrVar->next;
+      algo_freeBlock((*list)->allocator, itrVar,
+                     sizeof(InlineNode) + (*list)->dataSize);
+      itrVar = next;
+    }
+    free(*list);
+    *list = NULL;
+  }
+}
+
+// Creates an empty doubly linked list for items of dataSize bytes.
+InlineDLinkedList *idllist_create(size_t dataSize, Allocator *allocator) {
+  if (dataSize == 0) {
+    return NULL;
+  } else {
+    InlineDLinkedList *list = calloc(1, sizeof(InlineDLinkedList));
+    if (list == NULL) {
+      return NULL;
+    }
+    list->dataSize = dataSize;
+    list->allocator = allocator;
+    return list;
+  }
+}
+
+// Copies the data into a new node at the tail.
+int idllist_push(InlineDLinkedList *list, const void *data) {
+  if (list == NULL || data == NULL) {
+    return 0;
+  } else {
+    InlineDLNode *item = algo_allocBlock(list->allocator,
+                                         sizeof(InlineDLNode) + list->dataSize);
+    if (item == NULL) {
+      return 0;
+    }
+    memcpy(item->data, data, list->dataSize);
+    item->next = NULL;
+    item->prev = list->tail;
+    if (list->tail == NULL) {
+      list->head = item;
+    } else {
+      list->tail->next = item;
+    }
+    list->tail = item;
+    list->size++;
+    return 1;
+  }
+}
+
+// Removes the head and copies its data to out, if out is not NULL.
+int idllist_pop(InlineDLinkedList *list, void *out) {
+  if (list == NULL || list->head == NULL) {
+    return 0;
+  } else {
+    InlineDLNode *item = list->head;
+    if (out != NULL) {
+      memcpy(out, item->data, list->dataSize);
+    }
+    list->head = item->next;
+    if (list->head == NULL) {
+      list->tail = NULL;
+    } else {
+      list->head->prev = NULL;
+    }
+    algo_freeBlock(list->allocator, item,
+                   sizeof(InlineDLNode) + list->dataSize);
+    list->size--;
+    return 1;
+  }
+}
+
+uint64_t idllist_size(InlineDLinkedList *list) {
+  return (list == NULL) ? 0 : list->size;
+}
+
+void idllist_delete(InlineDLinkedList **list) {
+  if (list == NULL || *list == NULL) {
+    return;
+  } else {
+    while (idllist_pop(*list, NULL)) {
+    }
+    free(*list);
+    *list = NULL;
+  }
+}
+
+// Creates an empty stack for items of dataSize bytes.
+InlineStack *istack_create(size_t dataSize, Allocator *allocator) {
+  if (dataSize == 0) {
+    return NULL;
+  } else {
+    InlineStack *stack = calloc(1, sizeof(InlineStack));
+    if (stack == NULL) {
+      return NULL;
+    }
+    stack->dataSize = dataSize;
+    stack->allocator = allocator;
+    return stack;
+  }
+}
+
+int istack_push(InlineStack *stack, const void *data) {
+  if (stack == NULL || data == NULL) {
+    return 0;
+  } else {
+    InlineStackNode *item = algo_allocBlock(
+        stack->allocator, sizeof(InlineStackNode) + stack->dataSize);
+    if (item == NULL) {
+      return 0;
+    }
+    memcpy(item->data, data, stack->dataSize);
+    item->next = stack->top;
+    stack->top = item;
+    stack->size++;
+    return 1;
+  }
+}
+
+// Removes the top and copies its data to out, if out is not NULL.
+int istack_pop(InlineStack *stack, void *out) {
+  if (stack == NULL || stack->top == NULL) {
+    return 0;
+  } else {
+    InlineStackNode *item = stack->top;
+    if (out != NULL) {
+      memcpy(out, item->data, stack->dataSize);
+    }
+    stack->top = item->next;
+    algo_freeBlock(stack->allocator, item,
+                   sizeof(InlineStackNode) + stack->dataSize);
+    stack->size--;
+    return 1;
+  }
+}
+
+// Returns the data of the top, it stays valid until the next pop.
+void *istack_top(InlineStack *stack) {
+  if (stack == NULL || stack->top == NULL) {
+    return NULL;
+  } else {
+    return stack->top->data;
+  }
+}
+
+int istack_empty(InlineStack *stack) {
+  return stack == NULL || stack->top == NULL;
+}
+
+void istack_delete(InlineStack **stack) {
+  if (stack == NULL || *stack == NULL) {
+    return;
+  } else {
+    while (istack_pop(*stack, NULL)) {
+    }
+    free(*stack);
+    *stack = NULL;
+  }
+}
+
+// Prints the time per element to build a LinkedList and an InlineLinkedList
+// and to sum up their data, for 1000 up to count items. The heap gets
+// scrambled before every run, like in a program that does more than building
+// one list, so the nodes are not just laid out one after another. The inline
+// list wins once its smaller footprint still fits into a cache level that the
+// LinkedList does not fit into anymore.
+void inline_benchmark(uint64_t count) {
+  uint64_t state = 1;
+  printf("%-10s %-14s %-14s %-14s %-14s %-6s\n", "items", "build ns",
+         "inline build", "sum ns", "inline sum", "check");
+  for (uint64_t items = 1000; items <= count; items *= 4) {
+    // Free a batch of blocks of the node sizes in random order, the lists
+    // get their nodes from the scrambled free lists.
+    uint64_t blocks = 3 * items;
+    void **noise = malloc(blocks * sizeof(void *));
+    for (uint64_t i = 0; i < blocks; i++) {
+      noise[i] = malloc(8 + (i % 3) * 16);
+    }
+    for (uint64_t i = blocks - 1; i > 0; i--) {
+      uint64_t j = algo_random(&state) % (i + 1);
+      void *temp = noise[i];
+      noise[i] = noise[j];
+      noise[j] = temp;
+    }
+    for (uint64_t i = 0; i < blocks; i++) {
+      free(noise[i]);
+    }
+    free(noise);
+
+    double times[2][2];
+    uint64_t sums[2] = {0, 0};
+    uint64_t rounds = 1 + (1 << 22) / items;
+    double start = algo_seconds();
+    LinkedList *list = llist_createList(&sums[0], sizeof(uint64_t));
+    for (uint64_t i = 1; i < items; i++) {
+      llist_appendItem(list, &i, sizeof(i));
+    }
+    times[0][0] = algo_seconds() - start;
+    start = algo_seconds();
+    InlineLinkedList *inlineList = illist_create(sizeof(uint64_t), NULL);
+    for (uint64_t i = 0; i < items; i++) {
+      illist_appendItem(inlineList, &i);
+    }
+    times[1][0] = algo_seconds() - start;
+
+    start = algo_seconds();
+    for (uint64_t round = 0; round < rounds; round++) {
+      for (node *itrVar = list->front; itrVar != NULL; itrVar = itrVar->next) {
+        sums[0] += *(uint64_t *)itrVar->data;
+      }
+    }
+    times[0][1] = algo_seconds() - start;
+    start = algo_seconds();
+    for (uint64_t round = 0; round < rounds; round++) {
+      for (InlineNode *itrVar = inlineList->front; itrVar != NULL;
+           itrVar = itrVar->next) {
+        sums[1] += *(uint64_t *)itrVar->data;
+      }
+    }
+    times[1][1] = algo_seconds() - start;
+    llist_deleteList(list, NULL);
+    free(list);
+    illist_delete(&inlineList);
+
+    printf("%-10llu %-14.2f %-14.2f %-14.2f %-14.2f %-6s\n",
+           (unsigned long long)items,
+           times[0][0] * 1e9 / (double)items,
+           times[1][0] * 1e9 / (double)items,
+           times[0][1] * 1e9 / (double)(rounds * items),
+           times[1][1] * 1e9 / (double)(rounds * items),
+           (sums[0] == sums[1]) ? "ok" : "FAIL");
+  }
+}
+
+// Unrolled list:
+
+// Address of the element at offset index of the used part of the node.
+static unsigned char *ullist_slot(UnrolledList *list, UnrolledNode *node,
+                                  uint64_t index) {
+  return node->data + (node->first + index) * list->dataSize;
+}
+
+// Allocates an empty node and links it in after the node after, or at the
+// head if after is NULL.
+static UnrolledNode *ullist_insertNode(UnrolledList *list,
+                                       UnrolledNode *after) {
+  UnrolledNode *node =
+      malloc(sizeof(UnrolledNode) + list->nodeCapacity * list->dataSize);
+  if (node == NULL) {
+    return NULL;
+  }
+  node->first = 0;
+  node->count = 0;
+  node->prev = after;
+  node->next = (after == NULL) ? list->head : after->next;
+  if (node->next != NULL) {
+    node->next->prev = node;
+  } else {
+    list->tail = node;
+  }
+  if (after != NULL) {
+    after->next = node;
+  } else {
+    list->head = node;
+  }
+  return node;
+}
+
+static void ullist_removeNode(UnrolledList *list, UnrolledNode *node) {
+  if (node->prev != NULL) {
+    node->prev->next = node->next;
+  } else {
+    list->head = node->next;
+  }
+  if (node->next != NULL) {
+    node->next->prev = node->prev;
+  } else {
+    list->tail = node->prev;
+  }
+  free(node);
+}
+
+// Returns the node holding the element at the position and replaces the
+// position with the offset inside of the node. The walk starts at the closer
+// end of the list.
+static UnrolledNode *ullist_locate(UnrolledList *list, uint64_t *position) {
+  if (*position < list->size / 2) {
+    UnrolledNode *node = list->head;
+    while (*position >= node->count) {
+      *position -= node->count;
+      node = node->next;
+    }
+    return node;
+  } else {
+    UnrolledNode *node = list->tail;
+    uint64_t fromBack = list->size - *position;
+    while (fromBack > node->count) {
+      fromBack -= node->count;
+      node = node->prev;
+    }
+    *position = node->count - fromBack;
+    return node;
+  }
+}
+
+// Creates an empty unrolled list for elements of dataSize bytes. A node holds
+// as many of them as fit into ULLIST_NODE_BYTES, but at least one.
+UnrolledList *ullist_create(size_t dataSize) {
+  if (dataSize == 0) {
+    return NULL;
+  } else {
+    UnrolledList *list = calloc(1, sizeof(UnrolledList));
+    list->dataSize = dataSize;
+    list->nodeCapacity = (ULLIST_NODE_BYTES - sizeof(UnrolledNode)) / dataSize;
+    if (list->nodeCapacity == 0 ||
+        ULLIST_NODE_BYTES < sizeof(UnrolledNode) + dataSize) {
+      list->nodeCapacity = 1;
+    }
+    return list;
+  }
+}
+
+uint64_t ullist_size(UnrolledList *list) {
+  return (list == NULL) ? 0 : list->size;
+}
+
+// Returns a pointer to the element at the position, it stays valid until the
+// list is changed.
+void *ullist_at(UnrolledList *list, uint64_t position) {
+  if (list == NULL || position >= list->size) {
+    return NULL;
+  } else {
+    UnrolledNode *node = ullist_locate(list, &position);
+    return ullist_slot(list, node, position);
+  }
+}
+
+// Copies the data to the end of the list.
+int ullist_push(UnrolledList *list, const void *data) {
+  if (list == NULL || data == NULL) {
+    return 0;
+  } else {
+    UnrolledNode *node = list->tail;
+    if (node == NULL || node->first + node->count == list->nodeCapacity) {
+      node = ullist_insertNode(list, list->tail);
+      if (node == NULL) {
+        return 0;
+      }
+    }
+    memcpy(ullist_slot(list, node, node->count), data, list->dataSize);
+    node->count++;
+    list->size++;
+    return 1;
+  }
+}
+
+// Copies the data to the start of the list.
+int ullist_pushFront(UnrolledList *list, const void *data) {
+  if (list == NULL || data == NULL) {
+    return 0;
+  } else {
+    UnrolledNode *node = list->head;
+    if (node == NULL || node->first == 0) {
+      // The new node gets filled from its end towards its start.
+      node = ullist_insertNode(list, NULL);
+      if (node == NULL) {
+        return 0;
+      }
+      node->first = list->nodeCapacity;
+    }
+    node->first--;
+    node->count++;
+    memcpy(ullist_slot(list, node, 0), data, list->dataSize);
+    list->size++;
+    return 1;
+  }
+}
+
+// Removes the first element and copies it to out, if out is not NULL.
+int ullist_pop(UnrolledList *list, void *out) {
+  if (list == NULL || list->size == 0) {
+    return 0;
+  } else {
+    UnrolledNode *node = list->head;
+    if (out != NULL) {
+      memcpy(out, ullist_slot(list, node, 0), list->dataSize);
+    }
+    node->first++;
+    node->count--;
+    if (node->count == 0) {
+      ullist_removeNode(list, node);
+    }
+    list->size--;
+    return 1;
+  }
+}
+
+// Removes the last element and copies it to out, if out is not NULL.
+int ullist_popBack(UnrolledList *list, void *out) {
+  if (list == NULL || list->size == 0) {
+    return 0;
+  } else {
+    UnrolledNode *node = list->tail;
+    node->count--;
+    if (out != NULL) {
+      memcpy(out, ullist_slot(list, node, node->count), list->dataSize);
+    }
+    if (node->count == 0) {
+      ullist_removeNode(list, node);
+    }
+    list->size--;
+    return 1;
+  }
+}
+
+// Copies the data to the position, the elements from there on move back by
+// one. A full node gets split in half first, so only O(nodeCapacity) bytes
+// are moved.
+int ullist_insertAt(UnrolledList *list, uint64_t position, const void *data) {
+  if (list == NULL || data == NULL || position > list->size) {
+    return 0;
+  } else if (position == list->size) {
+    return ullist_push(list, data);
+  } else {
+    size_t dataSize = list->dataSize;
+    UnrolledNode *node = ullist_locate(list, &position);
+    if (node->count == list->nodeCapacity) {
+      UnrolledNode *upper = ullist_insertNode(list, node);
+      if (upper == NULL) {
+        return 0;
+      }
+      uint64_t half = node->count / 2;
+      upper->count = node->count - half;
+      memcpy(upper->data, ullist_slot(list, node, half),
+             upper->count * dataSize);
+      node->count = half;
+      if (position > half) {
+        node = upper;
+        position -= half;
+      }
+    }
+    if (node->first + node->count < list->nodeCapacity) {
+      // Move the elements after the position back.
+      unsigned char *slot = ullist_slot(list, node, position);
+      memmove(slot + dataSize, slot, (node->count - position) * dataSize);
+    } else {
+      // No room behind the elements, move the ones before the position to
+      // the front instead.
+      unsigned char *start = ullist_slot(list, node, 0);
+      memmove(start - dataSize, start, position * dataSize);
+      node->first--;
+    }
+    memcpy(ullist_slot(list, node, position), data, dataSize);
+    node->count++;
+    list->size++;
+    return 1;
+  }
+}
+
+// Removes the element at the position and copies it to out, if out is not
+// NULL. A node that drops below a quarter of its capacity takes over the
+// elements of its successor if they fit into half of it.
+int ullist_removeAt(UnrolledList *list, uint64_t position, void *out) {
+  if (list == NULL || position >= list->size) {
+    return 0;
+  } else {
+    size_t dataSize = list->dataSize;
+    UnrolledNode *node = ullist_locate(list, &position);
+    unsigned char *slot = ullist_slot(list, node, position);
+    if (out != NULL) {
+      memcpy(out, slot, dataSize);
+    }
+    // Close the gap from the shorter side.
+    if (position < node->count / 2) {
+      unsigned char *start = ullist_slot(list, node, 0);
+      memmove(start + dataSize, start, position * dataSize);
+      node->first++;
+    } else {
+      memmove(slot, slot + dataSize, (node->count - position - 1) * dataSize);
+    }
+    node->count--;
+    list->size--;
+    if (node->count == 0) {
+      ullist_removeNode(list, node);
+    } else if (node->count < list->nodeCapacity / 4 && node->next != NULL &&
+               node->count + node->next->count <= list->nodeCapacity / 2) {
+      UnrolledNode *next = node->next;
+      memmove(node->data, ullist_slot(list, node, 0), node->count * dataSize);
+      node->first = 0;
+      memcpy(ullist_slot(list, node, node->count), ullist_slot(list, next, 0),
+             next->count * dataSize);
+      node->count += next->count;
+      ullist_removeNode(list, next);
+    }
+    return 1;
+  }
+}
+
+// Returns an iterator that starts at the first element.
+UnrolledIterator ullist_begin(UnrolledList *list) {
+  UnrolledIterator iterator = {NULL, 0, 0};
+  if (list != NULL) {
+    iterator.node = list->head;
+    iterator.dataSize = list->dataSize;
+  }
+  return iterator;
+}
+
+// Returns the next element of the iteration or NULL at the end.
+void *ullist_iterNext(UnrolledIterator *iterator) {
+  if (iterator->node != NULL && iterator->index == iterator->node->count) {
+    iterator->node = iterator->node->next;
+    iterator->index = 0;
+  }
+  if (iterator->node == NULL) {
+    return NULL;
+  } else {
+    UnrolledNode *node = iterator->node;
+    return node->data + (node->first + iterator->index++) * iterator->dataSize;
+  }
+}
+
+// Returns the remaining elements of the current node as one array of count
+// elements and moves on to the next node, NULL at the end. A scan over the
+// chunks runs at nearly the speed of a scan over an array.
+void *ullist_nextChunk(UnrolledIterator *iterator, uint64_t *count) {
+  if (iterator->node == NULL) {
+    *count = 0;
+    return NULL;
+  } else {
+    UnrolledNode *node = iterator->node;
+    *count = node->count - iterator->index;
+    iterator->node = node->next;
+    uint64_t index = iterator->index;
+    iterator->index = 0;
+    return node->data + (node->first + index) * iterator->dataSize;
+  }
+}
+
+void ullist_delete(UnrolledList **list) {
+  if (list == NULL || *list == NULL) {
+    return;
+  } else {
+    UnrolledNode *node = (*list)->head;
+    while (node != NULL) {
+      UnrolledNode *next = node->next;
+      free(node);
+      node = next;
+    }
+    free(*list);
+    *list = NULL;
+  }
+}
+
+// Prints the time per element to append count integers to a DLinkedList, an
+// UnrolledList and a Uint64Array and to sum them up, and the time of an insert
+// and a remove at a random position of the unrolled list and the array.
+void ullist_benchmark(uint64_t count) {
+  double times[3][3] = {{0}};
+  uint64_t sums[4] = {0, 0, 0, 0};
+  uint64_t value = 0, state = 1;
+  uint64_t edits = 4096;
+
+  double start = algo_seconds();
+  DLinkedList *dlist = dllist_initialization(&value, sizeof(value));
+  for (uint64_t i = 1; i < count; i++) {
+    dllist_push(dlist, &i, sizeof(i));
+  }
+  times[0][0] = algo_seconds() - start;
+  start = algo_seconds();
+  for (DLNode *itrVar = dlist->head; itrVar != NULL; itrVar = itrVar->next) {
+    sums[0] += *(uint64_t *)itrVar->data;
+  }
+  times[0][1] = algo_seconds() - start;
+
+  start = algo_seconds();
+  UnrolledList *list = ullist_create(sizeof(uint64_t));
+  for (uint64_t i = 0; i < count; i++) {
+    ullist_push(list, &i);
+  }
+  times[1][0] = algo_seconds() - start;
+  start = algo_seconds();
+  UnrolledIterator iterator = ullist_begin(list);
+  uint64_t chunkSize = 0;
+  uint64_t *chunk = NULL;
+  while ((chunk = ullist_nextChunk(&iterator, &chunkSize)) != NULL) {
+    for (uint64_t i = 0; i < chunkSize; i++) {
+      sums[1] += chunk[i];
+    }
+  }
+  times[1][1] = algo_seconds() - start;
+  iterator = ullist_begin(list);
+  for (uint64_t *item; (item = ullist_iterNext(&iterator)) != NULL;) {
+    sums[3] += *item;
+  }
+  start = algo_seconds();
+  for (uint64_t i = 0; i < edits; i++) {
+    ullist_insertAt(list, algo_random(&state) % list->size, &i);
+    ullist_removeAt(list, algo_random(&state) % list->size, NULL);
+  }
+  times[1][2] = algo_seconds() - start;
+  ullist_delete(&list);
+
+  start = algo_seconds();
+  Uint64Array *array = uint64arr_initialize(16);
+  for (uint64_t i = 0; i < count; i++) {
+    uint64arr_add(array, i);
+  }
+  times[2][0] = algo_seconds() - start;
+  start = algo_seconds();
+  for (uint64_t i = 0; i < array->size; i++) {
+    sums[2] += uint64arr_get(array, i);
+  }
+  times[2][1] = algo_seconds() - start;
+  start = algo_seconds();
+  for (uint64_t i = 0; i < edits; i++) {
+    uint64arr_addAt(array, i, algo_random(&state) % array->size);
+    uint64arr_removeAt(array, algo_random(&state) % array->size, NULL);
+  }
+  times[2][2] = algo_seconds() - start;
+  uint64arr_delete(&array);
+  // Torn down last, the pages it gives back would otherwise have to be
+  // faulted in again by the other containers.
+  while (dlist->size) {
+    dllist_freeNode(dlist, dllist_pop(dlist));
+  }
+  free(dlist);
+
+  printf("%-14s %-12s %-12s %-12s %-6s\n", "container", "append ns",
+         "scan ns", "edit ns", "check");
+  const char *names[] = {"DLinkedList", "UnrolledList", "Uint64Array"};
+  for (int i = 0; i < 3; i++) {
+    printf("%-14s %-12.2f %-12.2f ", names[i],
+           times[i][0] * 1e9 / (double)count,
+           times[i][1] * 1e9 / (double)count);
+    if (i == 0) {
+      printf("%-12s ", "-");
+    } else {
+      printf("%-12.1f ", times[i][2] * 1e9 / (double)edits);
+    }
+    printf("%-6s\n",
+           (sums[i] == sums[0] && sums[3] == sums[0]) ? "ok" : "FAIL");
+  }
+}
+
+// Ring buffer deque:
+
+static unsigned char *deque_slot(RingDeque *deque, uint64_t position) {
+  return deque->data +
+         ((deque->head + position) & (deque->capacity - 1)) * deque->dataSize;
+}
+
+// Copies count elements from the position on out of the ring, which takes at
+// most two memcpy calls as the range may wrap around the end of the buffer.
+static void deque_copyRange(RingDeque *deque, uint64_t position,
+                            unsigned char *out, uint64_t count) {
+  uint64_t start = (deque->head + position) & (deque->capacity - 1);
+  uint64_t first = deque->capacity - start;
+  if (first > count) {
+    first = count;
+  }
+  memcpy(out, deque->data + start * deque->dataSize, first * deque->dataSize);
+  memcpy(out + first * deque->dataSize, deque->data,
+         (count - first) * deque->dataSize);
+}
+
+// Creates an empty deque for elements of dataSize bytes, the capacity gets
+// rounded up to a power of two.
+RingDeque *deque_create(size_t dataSize, uint64_t initialCapacity) {
+  if (dataSize == 0) {
+    return NULL;
+  } else {
+    RingDeque *deque = calloc(1, sizeof(RingDeque));
+    if (deque == NULL) {
+      return NULL;
+    }
+    deque->dataSize = dataSize;
+    if (!deque_reserve(deque, initialCapacity ? initialCapacity : 16)) {
+      free(deque);
+      return NULL;
+    }
+    return deque;
+  }
+}
+
+uint64_t deque_size(RingDeque *deque) {
+  return (deque == NULL) ? 0 : deque->size;
+}
+
+// Grows the buffer to hold at least capacity elements. The elements get
+// unwrapped to the start of the new buffer.
+int deque_reserve(RingDeque *deque, uint64_t capacity) {
+  if (deque == NULL) {
+    return 0;
+  } else if (capacity <= deque->capacity) {
+    return 1;
+  } else {
+    uint64_t size = deque->capacity ? deque->capacity : 1;
+    while (size < capacity) {
+      size *= 2;
+    }
+    unsigned char *data = malloc(size * deque->dataSize);
+    if (data == NULL) {
+      return 0;
+    }
+    if (deque->size) {
+      deque_copyRange(deque, 0, data, deque->size);
+    }
+    free(deque->data);
+    deque->data = data;
+    deque->capacity = size;
+    deque->head = 0;
+    return 1;
+  }
+}
+
+// Returns a pointer to the element at the position counted from the front, it
+// stays valid until the deque grows.
+void *deque_at(RingDeque *deque, uint64_t position) {
+  if (deque == NULL || position >= deque->size) {
+    return NULL;
+  } else {
+    return deque_slot(deque, position);
+  }
+}
+
+int deque_pushBack(RingDeque *deque, const void *data) {
+  if (deque == NULL || data == NULL ||
+      (deque->size == deque->capacity &&
+       !deque_reserve(deque, deque->capacity * 2))) {
+    return 0;
+  } else {
+    memcpy(deque_slot(deque, deque->size), data, deque->dataSize);
+    deque->size++;
+    return 1;
+  }
+}
+
+int deque_pushFront(RingDeque *deque, const void *data) {
+  if (deque == NULL || data == NULL ||
+      (deque->size == deque->capacity &&
+       !deque_reserve(deque, deque->capacity * 2))) {
+    return 0;
+  } else {
+    deque->head = (deque->head - 1) & (deque->capacity - 1);
+    memcpy(deque_slot(deque, 0), data, deque->dataSize);
+    deque->size++;
+    return 1;
+  }
+}
+
+// Removes the first element and copies it to out, if out is not NULL.
+int deque_popFront(RingDeque *deque, void *out) {
+  if (deque == NULL || deque->size == 0) {
+    return 0;
+  } else {
+    if (out != NULL) {
+      memcpy(out, deque_slot(deque, 0), deque->dataSize);
+    }
+    deque->head = (deque->head + 1) & (deque->capacity - 1);
+    deque->size--;
+    return 1;
+  }
+}
+
+// Removes the last element and copies it to out, if out is not NULL.
+int deque_popBack(RingDeque *deque, void *out) {
+  if (deque == NULL || deque->size == 0) {
+    return 0;
+  } else {
+    deque->size--;
+    if (out != NULL) {
+      memcpy(out, deque_slot(deque, deque->size), deque->dataSize);
+    }
+    return 1;
+  }
+}
+
+// Appends the count elements of the array data, with at most two memcpy
+// calls after the buffer grew once to fit them.
+int deque_pushBackN(RingDeque *deque, const void *data, uint64_t count) {
+  if (deque == NULL || data == NULL ||
+      !deque_reserve(deque, deque->size + count)) {
+    return 0;
+  } else {
+    uint64_t start = (deque->head + deque->size) & (deque->capacity - 1);
+    uint64_t first = deque->capacity - start;
+    if (first > count) {
+      first = count;
+    }
+    memcpy(deque->data + start * deque->dataSize, data,
+           first * deque->dataSize);
+    memcpy(deque->data, (const unsigned char *)data + first * deque->dataSize,
+           (count - first) * deque->dataSize);
+    deque->size += count;
+    return 1;
+  }
+}
+
+// Removes up to count elements from the front into the array out and returns
+// how many there were.
+uint64_t deque_popFrontN(RingDeque *deque, void *out, uint64_t count) {
+  if (deque == NULL) {
+    return 0;
+  } else {
+    if (count > deque->size) {
+      count = deque->size;
+    }
+    if (out != NULL) {
+      deque_copyRange(deque, 0, out, count);
+    }
+    deque->head = (deque->head + count) & (deque->capacity - 1);
+    deque->size -= count;
+    return count;
+  }
+}
+
+// Copies up to count elements from the position on into the array out
+// without removing them and returns how many were copied.
+uint64_t deque_copyOut(RingDeque *deque, uint64_t position, void *out,
+                       uint64_t count) {
+  if (deque == NULL || out == NULL || position >= deque->size) {
+    return 0;
+  } else {
+    if (count > deque->size - position) {
+      count = deque->size - position;
+    }
+    deque_copyRange(deque, position, out, count);
+    return count;
+  }
+}
+
+void deque_clear(RingDeque *deque) {
+  if (deque != NULL) {
+    deque->head = 0;
+    deque->size = 0;
+  }
+}
+
+void deque_delete(RingDeque **deque) {
+  if (deque == NULL || *deque == NULL) {
+    return;
+  } else {
+    free((*deque)->data);
+    free(*deque);
+    *deque = NULL;
+  }
+}
+
+// Prints the time per element of a Queue and a RingDeque that cycle count
+// integers through a window of 1024 entries, and of a Stack and a RingDeque
+// that push count integers and pop them again.
+void deque_benchmark(uint64_t count) {
+  double times[2][2];
+  uint64_t sums[2][2] = {{0, 0}, {0, 0}};
+  uint64_t zero = 0;
+  uint64_t value = 0;
+
+  double start = algo_seconds();
+  Queue *queue = queue_initialize(&zero, sizeof(zero));
+  for (uint64_t i = 1; i < count; i++) {
+    queue_enqueue(queue, &i, sizeof(i));
+    if (i >= 1024) {
+      DLNode *item = queue_dequeue(queue);
+      sums[0][0] += *(uint64_t *)item->data;
+      queue_freeNode(queue, item);
+    }
+  }
+  while (queue->size) {
+    DLNode *item = queue_dequeue(queue);
+    sums[0][0] += *(uint64_t *)item->data;
+    queue_freeNode(queue, item);
+  }
+  times[0][0] = algo_seconds() - start;
+  free(queue);
+
+  start = algo_seconds();
+  RingDeque *deque = deque_create(sizeof(uint64_t), 0);
+  for (uint64_t i = 0; i < count; i++) {
+    deque_pushBack(deque, &i);
+    if (i >= 1024) {
+      deque_popFront(deque, &value);
+      sums[1][0] += value;
+    }
+  }
+  while (deque_popFront(deque, &value)) {
+    sums[1][0] += value;
+  }
+  times[1][0] = algo_seconds() - start;
+  deque_delete(&deque);
+
+  start = algo_seconds();
+  Stack *stack = stack_create(&zero, sizeof(zero));
+  for (uint64_t i = 1; i < count; i++) {
+    stack_push(&stack, &i, sizeof(i));
+  }
+  while (stack != NULL) {
+    Stack *item = stack_pop(&stack);
+    sums[0][1] += *(uint64_t *)item->data;
+    stack_freeNode(item);
+  }
+  times[0][1] = algo_seconds() - start;
+
+  start = algo_seconds();
+  deque = deque_create(sizeof(uint64_t), 0);
+  for (uint64_t i = 0; i < count; i++) {
+    deque_pushBack(deque, &i);
+  }
+  while (deque_popBack(deque, &value)) {
+    sums[1][1] += value;
+  }
+  times[1][1] = algo_seconds() - start;
+  deque_delete(&deque);
+
+  printf("%-12s %-12s %-12s %-6s\n", "container", "queue ns", "stack ns",
+         "check");
+  const char *names[] = {"list based", "RingDeque"};
+  for (int i = 0; i < 2; i++) {
+    printf("%-12s %-12.2f %-12.2f %-6s\n", names[i],
+           times[i][0] * 1e9 / (double)count, times[i][1] * 1e9 / (double)count,
+           (sums[i][0] == sums[0][0] && sums[i][1] == sums[0][1]) ? "ok"
+                                                                  : "FAIL");
+  }
+}
+
+// Exexcutes a simple xor swap on the variables a and b.
+void xorswap(int *a, int *b) {
+  // Set the value of a to the xor of a and b
+  *a = *a ^ *b;
+  // Set the value of b to the xor of itself and the xor of the new a and the
+  // previous b.
+  *b = *a ^ *b;
+  // xor the new values of a and b again.
+  *a = *a ^ *b;
+}
+
+// Recursively calculates the factorial of the number in the argument.
+uint64_t factorial(uint64_t number) {
+  if (number == 0 || number == 1) {
+    return 1;
+  } else {
+    return factorial(number - 1) * number;
+  }
+}
+// Calculate the factorial of the number in the argument with iteration.
+uint64_t factorialNR(uint64_t number) {
+  uint64_t fact = 1;
+  for (uint64_t i = 2; i <= number; i++) {
+    fact *= i;
+  }
+  return fact;
+}
+
+// Arbitrary precision integers:
+
+// Factors below which a subtree of the factorial product tree multiplies them
+// one by one.
+#define BIGINT_FACTORIAL_LEAF 16
+// Factors from which on a subtree of the product tree may get its own thread.
+#define BIGINT_FACTORIAL_PARALLEL 2048
+
+// Sets r = a + b for n limbs each and returns the carry.
+static uint64_t bigint_addN(uint64_t *r, const uint64_t *a, const uint64_t *b,
+                            uint64_t n) {
+  uint64_t carry = 0;
+  for (uint64_t i = 0; i < n; i++) {
+    uint64_t sum = a[i] + carry;
+    carry = sum < carry;
+    r[i] = sum + b[i];
+    carry += r[i] < sum;
+  }
+  return carry;
+}
+
+// Sets r = a - b for n limbs each and returns the borrow.
+static uint64_t bigint_subN(uint64_t *r, const uint64_t *a, const uint64_t *b,
+                            uint64_t n) {
+  uint64_t borrow = 0;
+  for (uint64_t i = 0; i < n; i++) {
+    uint64_t difference = a[i] - b[i];
+    uint64_t below = a[i] < b[i];
+    r[i] = difference - borrow;
+    borrow = below | (difference < borrow);
+  }
+  return borrow;
+}
+
+// Adds the an limbs of a to the rn >= an limbs of r and returns the carry out
+// of r.
+static uint64_t bigint_addTo(uint64_t *r, uint64_t rn, const uint64_t *a,
+                             uint64_t an) {
+  uint64_t carry = bigint_addN(r, r, a, an);
+  for (uint64_t i = an; carry && i < rn; i++) {
+    carry = ++r[i] == 0;
+  }
+  return carry;
+}
+
+// Subtracts the an limbs of a from the rn >= an limbs of r and returns the
+// borrow out of r.
+static uint64_t bigint_subFrom(uint64_t *r, uint64_t rn, const uint64_t *a,
+                               uint64_t an) {
+  uint64_t borrow = bigint_subN(r, r, a, an);
+  for (uint64_t i = an; borrow && i < rn; i++) {
+    borrow = r[i]-- == 0;
+  }
+  return borrow;
+}
+
+static int bigint_compareN(const uint64_t *a, const uint64_t *b, uint64_t n) {
+  while (n-- > 0) {
+    if (a[n] != b[n]) {
+      return (a[n] > b[n]) ? 1 : -1;
+    }
+  }
+  return 0;
+}
+
+// Sets the an limbs of r to |a - b| for the bn <= an limbs of b and returns 1
+// if a < b.
+static int bigint_absDiff(uint64_t *r, const uint64_t *a, uint64_t an,
+                          const uint64_t *b, uint64_t bn) {
+  uint64_t high = an;
+  while (high > bn && a[high - 1] == 0) {
+    high--;
+  }
+  if (high == bn && bigint_compareN(a, b, bn) < 0) {
+    bigint_subN(r, b, a, bn);
+    memset(r + bn, 0, (an - bn) * sizeof(uint64_t));
+    return 1;
+  } else {
+    memcpy(r, a, an * sizeof(uint64_t));
+    bigint_subFrom(r, an, b, bn);
+    return 0;
+  }
+}
+
+// Sets the an + bn limbs of r to a * b with the schoolbook method. r must not
+// overlap a or b.
+static void bigint_mulBasecase(uint64_t *r, const uint64_t *a, uint64_t an,
+                               const uint64_t *b, uint64_t bn) {
+  memset(r, 0, (an + bn) * sizeof(uint64_t));
+  for (uint64_t j = 0; j < bn; j++) {
+    uint64_t carry = 0;
+    for (uint64_t i = 0; i < an; i++) {
+      unsigned __int128 product =
+          (unsigned __int128)a[i] * b[j] + r[i + j] + carry;
+      r[i + j] = (uint64_t)product;
+      carry = (uint64_t)(product >> 64);
+    }
+    r[an + j] = carry;
+  }
+}
+
+// Returns the limbs of scratch space bigint_karatsuba needs for n limbs, the
+// halves only take the Karatsuba path again above the threshold.
+static uint64_t bigint_karatsubaScratch(uint64_t n) {
+  uint64_t size = 0;
+  do {
+    n = (n + 1) / 2;
+    size += 6 * n + 2;
+  } while (n >= BIGINT_KARATSUBA_THRESHOLD);
+  return size;
+}
+
+static int bigint_mulBalanced(uint64_t *r, const uint64_t *a,
+                              const uint64_t *b, uint64_t n, uint64_t *scratch);
+
+// Sets the 2n limbs of r to a * b for n limbs each. The product of the low
+// halves and the one of the high halves give the middle term together with
+// the product of the differences of the halves, so every level takes three
+// multiplications of half the size instead of four.
+static int bigint_karatsuba(uint64_t *r, const uint64_t *a, const uint64_t *b,
+                            uint64_t n, uint64_t *scratch) {
+  uint64_t m = (n + 1) / 2;
+  uint64_t h = n - m;
+  uint64_t *da = scratch;
+  uint64_t *db = scratch + m;
+  uint64_t *t = scratch + 2 * m;
+  uint64_t *middle = scratch + 4 * m;
+  uint64_t *next = scratch + 6 * m + 2;
+  int negative = bigint_absDiff(da, a, m, a + m, h) ^
+                 bigint_absDiff(db, b, m, b + m, h);
+  if (!bigint_mulBalanced(r, a, b, m, next) ||
+      !bigint_mulBalanced(r + 2 * m, a + m, b + m, h, next) ||
+      !bigint_mulBalanced(t, da, db, m, next)) {
+    return 0;
+  }
+  // a0 * b1 + a1 * b0 = a0 * b0 + a1 * b1 - (a0 - a1) * (b0 - b1).
+  memcpy(middle, r, 2 * m * sizeof(uint64_t));
+  middle[2 * m] = bigint_addTo(middle, 2 * m, r + 2 * m, 2 * h);
+  if (negative) {
+    bigint_addTo(middle, 2 * m + 1, t, 2 * m);
+  } else {
+    bigint_subFrom(middle, 2 * m + 1, t, 2 * m);
+  }
+  // The middle term fits into the product, so its leading limbs past the end
+  // are zero.
+  uint64_t size = 2 * m + 1;
+  while (size > 0 && middle[size - 1] == 0) {
+    size--;
+  }
+  bigint_addTo(r + m, 2 * n - m, middle, size);
+  return 1;
+}
+
+// Negates the n limbs of x in two's complement.
+static void bigint_negate(uint64_t *x, uint64_t n) {
+  uint64_t carry = 1;
+  for (uint64_t i = 0; i < n; i++) {
+    x[i] = ~x[i] + carry;
+    carry = carry && x[i] == 0;
+  }
+}
+
+// Halves the n limbs of x, which hold an even number in two's complement.
+static void bigint_halve(uint64_t *x, uint64_t n) {
+  for (uint64_t i = 0; i + 1 < n; i++) {
+    x[i] = (x[i] >> 1) | (x[i + 1] << 63);
+  }
+  x[n - 1] = (uint64_t)((int64_t)x[n - 1] >> 1);
+}
+
+// Divides the n limbs of x, which hold a multiple of 3 in two's complement, by
+// 3. It multiplies by the inverse of 3 modulo 2^64 limb by limb and carries
+// the part of the product that spills into the next limb.
+static void bigint_divExact3(uint64_t *x, uint64_t n) {
+  uint64_t borrow = 0;
+  for (uint64_t i = 0; i < n; i++) {
+    uint64_t value = x[i];
+    uint64_t below = value < borrow;
+    value -= borrow;
+    uint64_t quotient = value * 0xAAAAAAAAAAAAAAABULL;
+    x[i] = quotient;
+    borrow = below + (quotient >= 0x5555555555555556ULL) +
+             (quotient >= 0xAAAAAAAAAAAAAAABULL);
+  }
+}
+
+// Evaluates a0 + a1 x + a2 x^2 for the limbs of a split at k and 2k at x = 1,
+// -1 and -2 into k + 1 limbs each. Returns the signs of the values at -1 and
+// -2 in bit 0 and 1, the values themselves are stored as magnitudes.
+static int bigint_toomEvaluate(uint64_t *one, uint64_t *minusOne,
+                               uint64_t *minusTwo, const uint64_t *a,
+                               uint64_t k, uint64_t top) {
+  uint64_t e = k + 1;
+  memcpy(one, a, k * sizeof(uint64_t));
+  one[k] = 0;
+  bigint_addTo(one, e, a + 2 * k, top);
+  memcpy(minusOne, one, e * sizeof(uint64_t));
+  bigint_subFrom(minusOne, e, a + k, k);
+  bigint_addTo(one, e, a + k, k);
+  // p(-2) = 2 (p(-1) + a2) - a0, which stays below 7 * 2^64k in magnitude.
+  memcpy(minusTwo, minusOne, e * sizeof(uint64_t));
+  bigint_addTo(minusTwo, e, a + 2 * k, top);
+  bigint_addN(minusTwo, minusTwo, minusTwo, e);
+  bigint_subFrom(minusTwo, e, a, k);
+  int signs = 0;
+  if (minusOne[k] >> 63) {
+    bigint_negate(minusOne, e);
+    signs |= 1;
+  }
+  if (minusTwo[k] >> 63) {
+    bigint_negate(minusTwo, e);
+    signs |= 2;
+  }
+  return signs;
+}
+
+// Sets the 2n limbs of r to a * b for n limbs each. Both are split into three
+// parts and read as polynomials, whose product is interpolated from its
+// values at 0, 1, -1, -2 and infinity, so every level takes five
+// multiplications of a third of the size. The interpolation follows Bodrato
+// and works in two's complement. Returns 0 if the memory runs out.
+static int bigint_toom3(uint64_t *r, const uint64_t *a, const uint64_t *b,
+                        uint64_t n) {
+  uint64_t k = (n + 2) / 3;
+  uint64_t top = n - 2 * k;
+  uint64_t e = k + 1;
+  uint64_t l = 2 * e;
+  uint64_t *block =
+      malloc((6 * e + 4 * l + bigint_karatsubaScratch(e)) * sizeof(uint64_t));
+  if (block == NULL) {
+    return 0;
+  }
+  uint64_t *aOne = block;
+  uint64_t *bOne = aOne + e;
+  uint64_t *aMinusOne = bOne + e;
+  uint64_t *bMinusOne = aMinusOne + e;
+  uint64_t *aMinusTwo = bMinusOne + e;
+  uint64_t *bMinusTwo = aMinusTwo + e;
+  uint64_t *one = bMinusTwo + e;
+  uint64_t *minusOne = one + l;
+  uint64_t *minusTwo = minusOne + l;
+  uint64_t *three = minusTwo + l;
+  uint64_t *scratch = three + l;
+  int signs = bigint_toomEvaluate(aOne, aMinusOne, aMinusTwo, a, k, top) ^
+              bigint_toomEvaluate(bOne, bMinusOne, bMinusTwo, b, k, top);
+
+  // The values at 0 and infinity are the outer coefficients of the product.
+  memset(r + 2 * k, 0, 2 * k * sizeof(uint64_t));
+  if (!bigint_mulBalanced(r, a, b, k, scratch) ||
+      !bigint_mulBalanced(r + 4 * k, a + 2 * k, b + 2 * k, top, scratch) ||
+      !bigint_mulBalanced(one, aOne, bOne, e, scratch) ||
+      !bigint_mulBalanced(minusOne, aMinusOne, bMinusOne, e, scratch) ||
+      !bigint_mulBalanced(minusTwo, aMinusTwo, bMinusTwo, e, scratch)) {
+    free(block);
+    return 0;
+  }
+  if (signs & 1) {
+    bigint_negate(minusOne, l);
+  }
+  if (signs & 2) {
+    bigint_negate(minusTwo, l);
+  }
+  const uint64_t *zero = r;
+  const uint64_t *infinity = r + 4 * k;
+
+  // minusTwo = (r(-2) - r(1)) / 3
+  bigint_subFrom(minusTwo, l, one, l);
+  bigint_divExact3(minusTwo, l);
+  // one = (r(1) - r(-1)) / 2, the coefficient of x once three is known.
+  bigint_subFrom(one, l, minusOne, l);
+  bigint_halve(one, l);
+  // minusOne = r(-1) - r(0)
+  bigint_subFrom(minusOne, l, zero, 2 * k);
+  // three = (minusOne - minusTwo) / 2 + 2 r(infinity)
+  memcpy(three, minusOne, l * sizeof(uint64_t));
+  bigint_subFrom(three, l, minusTwo, l);
+  bigint_halve(three, l);
+  bigint_addTo(three, l, infinity, 2 * top);
+  bigint_addTo(three, l, infinity, 2 * top);
+  // minusOne = minusOne + one - r(infinity), the coefficient of x^2.
+  bigint_addTo(minusOne, l, one, l);
+  bigint_subFrom(minusOne, l, infinity, 2 * top);
+  bigint_subFrom(one, l, three, l);
+
+  // The inner coefficients are not negative and fit into the product.
+  uint64_t *coefficients[3] = {one, minusOne, three};
+  for (uint64_t i = 0; i < 3; i++) {
+    uint64_t size = l;
+    while (size > 0 && coefficients[i][size - 1] == 0) {
+      size--;
+    }
+    bigint_addTo(r + (i + 1) * k, 2 * n - (i + 1) * k, coefficients[i], size);
+  }
+  free(block);
+  return 1;
+}
+
+// Modulus of the number theoretic transform, p = 2^64 - 2^32 + 1. p - 1 is
+// divisible by 2^32, so there are roots of unity for transforms of up to 2^32
+// values, and 2^64 = 2^32 - 1 modulo p makes the reduction cheap.
+#define BIGINT_NTT_PRIME 0xFFFFFFFF00000001ULL
+#define BIGINT_NTT_EPSILON 0xFFFFFFFFULL
+// Generator of the multiplicative group modulo the prime.
+#define BIGINT_NTT_GENERATOR 7
+// Largest product in limbs the transform multiplies exactly, it cuts the
+// limbs into 2^32 pieces at most. Larger products take Toom-3.
+#define BIGINT_NTT_MAX_LIMBS (1ULL << 30)
+
+static uint64_t bigint_nttAdd(uint64_t a, uint64_t b) {
+  uint64_t sum = a + b;
+  return (sum < a || sum >= BIGINT_NTT_PRIME) ? sum - BIGINT_NTT_PRIME : sum;
+}
+
+static uint64_t bigint_nttSub(uint64_t a, uint64_t b) {
+  return (a < b) ? a - b + BIGINT_NTT_PRIME : a - b;
+}
+
+static uint64_t bigint_nttMul(uint64_t a, uint64_t b) {
+  unsigned __int128 product = (unsigned __int128)a * b;
+  uint64_t low = (uint64_t)product;
+  uint64_t high = (uint64_t)(product >> 64);
+  // With 2^64 = 2^32 - 1 and 2^96 = -1 the high word folds into the low one.
+  uint64_t result = low - (high >> 32);
+  if (low < (high >> 32)) {
+    result -= BIGINT_NTT_EPSILON;
+  }
+  uint64_t folded = (high & BIGINT_NTT_EPSILON) * BIGINT_NTT_EPSILON;
+  result += folded;
+  if (result < folded) {
+    result += BIGINT_NTT_EPSILON;
+  }
+  return (result >= BIGINT_NTT_PRIME) ? result - BIGINT_NTT_PRIME : result;
+}
+
+static uint64_t bigint_nttPow(uint64_t base, uint64_t exponent) {
+  uint64_t result = 1;
+  while (exponent) {
+    if (exponent & 1) {
+      result = bigint_nttMul(result, base);
+    }
+    base = bigint_nttMul(base, base);
+    exponent >>= 1;
+  }
+  return result;
+}
+
+// Replaces the n = 2^k values with their transform at the powers of root,
+// a primitive n-th root of unity, by iterative radix 2 butterflies. Returns 0
+// if the memory runs out.
+static int bigint_ntt(uint64_t *values, uint64_t n, uint64_t root) {
+  for (uint64_t i = 1, j = 0; i < n; i++) {
+    uint64_t bit = n >> 1;
+    for (; j & bit; bit >>= 1) {
+      j ^= bit;
+    }
+    j ^= bit;
+    if (i < j) {
+      uint64_t temp = values[i];
+      values[i] = values[j];
+      values[j] = temp;
+    }
+  }
+  uint64_t *powers = malloc((n / 2) * sizeof(uint64_t));
+  if (powers == NULL) {
+    return 0;
+  }
+  for (uint64_t length = 2; length <= n; length *= 2) {
+    uint64_t half = length / 2;
+    uint64_t step = bigint_nttPow(root, n / length);
+    powers[0] = 1;
+    for (uint64_t j = 1; j < half; j++) {
+      powers[j] = bigint_nttMul(powers[j - 1], step);
+    }
+    for (uint64_t start = 0; start < n; start += length) {
+      uint64_t *low = values + start;
+      uint64_t *high = low + half;
+      for (uint64_t j = 0; j < half; j++) {
+        uint64_t u = low[j];
+        uint64_t v = bigint_nttMul(high[j], powers[j]);
+        low[j] = bigint_nttAdd(u, v);
+        high[j] = bigint_nttSub(u, v);
+      }
+    }
+  }
+  free(powers);
+  return 1;
+}
+
+// Sets the an + bn limbs of r to a * b with a number theoretic transform. The
+// limbs are cut into 16 bit pieces, so the sums of the convolution stay below
+// the prime for up to 2^32 pieces. Returns 0 for larger products and if the
+// memory runs out.
+static int bigint_mulNtt(uint64_t *r, const uint64_t *a, uint64_t an,
+                         const uint64_t *b, uint64_t bn) {
+  if (an + bn > BIGINT_NTT_MAX_LIMBS) {
+    return 0;
+  }
+  uint64_t pieces = 4 * (an + bn);
+  uint64_t n = 2;
+  while (n < pieces) {
+    n *= 2;
+  }
+  int square = (a == b && an == bn);
+  uint64_t *fa = calloc(n, sizeof(uint64_t));
+  uint64_t *fb = square ? fa : calloc(n, sizeof(uint64_t));
+  if (fa == NULL || fb == NULL) {
+    free(fa);
+    if (!square) {
+      free(fb);
+    }
+    return 0;
+  }
+  for (uint64_t i = 0; i < 4 * an; i++) {
+    fa[i] = (a[i / 4] >> (16 * (i % 4))) & 0xFFFF;
+  }
+  for (uint64_t i = 0; !square && i < 4 * bn; i++) {
+    fb[i] = (b[i / 4] >> (16 * (i % 4))) & 0xFFFF;
+  }
+  uint64_t root = bigint_nttPow(BIGINT_NTT_GENERATOR,
+                                (BIGINT_NTT_PRIME - 1) / n);
+  int success = bigint_ntt(fa, n, root) && (square || bigint_ntt(fb, n, root));
+  for (uint64_t i = 0; success && i < n; i++) {
+    fa[i] = bigint_nttMul(fa[i], fb[i]);
+  }
+  // The inverse transform uses the inverse root and a division by n.
+  if (!success ||
+      !bigint_ntt(fa, n, bigint_nttPow(root, BIGINT_NTT_PRIME - 2))) {
+    free(fa);
+    if (!square) {
+      free(fb);
+    }
+    return 0;
+  }
+  uint64_t scale = bigint_nttPow(n, BIGINT_NTT_PRIME - 2);
+  memset(r, 0, (an + bn) * sizeof(uint64_t));
+  unsigned __int128 carry = 0;
+  for (uint64_t i = 0; i < pieces; i++) {
+    carry += bigint_nttMul(fa[i], scale);
+    r[i / 4] |= (uint64_t)(carry & 0xFFFF) << (16 * (i % 4));
+    carry >>= 16;
+  }
+  free(fa);
+  if (!square) {
+    free(fb);
+  }
+  return 1;
+}
+
+// Sets the 2n limbs of r to a * b for n limbs each with the method that is
+// the fastest for the size. The scratch space is used by Karatsuba. Returns 0
+// if the memory runs out.
+static int bigint_mulBalanced(uint64_t *r, const uint64_t *a,
+                              const uint64_t *b, uint64_t n,
+                              uint64_t *scratch) {
+  if (n < BIGINT_KARATSUBA_THRESHOLD) {
+    bigint_mulBasecase(r, a, n, b, n);
+    return 1;
+  } else if (n < BIGINT_TOOM3_THRESHOLD) {
+    return bigint_karatsuba(r, a, b, n, scratch);
+  } else if (n < BIGINT_NTT_THRESHOLD || 2 * n > BIGINT_NTT_MAX_LIMBS) {
+    return bigint_toom3(r, a, b, n);
+  } else {
+    return bigint_mulNtt(r, a, n, b, n);
+  }
+}
+
+// Sets the an + bn limbs of r to a * b for an >= bn >= 1. r must not overlap a
+// or b. Below the transform threshold, and above the largest product of the
+// transform, an unbalanced product is split into pieces of bn limbs of a.
+// Returns 0 if the memory runs out.
+static int bigint_mulLimbs(uint64_t *r, const uint64_t *a, uint64_t an,
+                           const uint64_t *b, uint64_t bn) {
+  if (bn < BIGINT_KARATSUBA_THRESHOLD) {
+    bigint_mulBasecase(r, a, an, b, bn);
+    return 1;
+  } else if (bn >= BIGINT_NTT_THRESHOLD && an + bn <= BIGINT_NTT_MAX_LIMBS) {
+    return bigint_mulNtt(r, a, an, b, bn);
+  }
+  uint64_t *scratch =
+      malloc((2 * bn + bigint_karatsubaScratch(bn)) * sizeof(uint64_t));
+  if (scratch == NULL) {
+    return 0;
+  }
+  int success = 1;
+  if (an == bn) {
+    success = bigint_mulBalanced(r, a, b, bn, scratch);
+  } else {
+    uint64_t *product = scratch;
+    memset(r, 0, (an + bn) * sizeof(uint64_t));
+    for (uint64_t i = 0; success && i < an; i += bn) {
+      uint64_t piece = (an - i < bn) ? an - i : bn;
+      if (piece == bn) {
+        success = bigint_mulBalanced(product, a + i, b, bn, scratch + 2 * bn);
+      } else {
+        success = bigint_mulLimbs(product, b, bn, a + i, piece);
+      }
+      bigint_addTo(r + i, an + bn - i, product, piece + bn);
+    }
+  }
+  free(scratch);
+  return success;
+}
+
+static int bigint_reserve(BigInt *number, uint64_t capacity) {
+  if (capacity <= number->capacity) {
+    return 1;
+  } else {
+    uint64_t *limbs = realloc(number->limbs, capacity * sizeof(uint64_t));
+    if (limbs == NULL) {
+      return 0;
+    }
+    number->limbs = limbs;
+    number->capacity = capacity;
+    return 1;
+  }
+}
+
+static void bigint_normalize(BigInt *number) {
+  while (number->size > 0 && number->limbs[number->size - 1] == 0) {
+    number->size--;
+  }
+}
+
+BigInt *bigint_create(uint64_t value) {
+  BigInt *number = calloc(1, sizeof(BigInt));
+  if (number == NULL || !bigint_set(number, value)) {
+    free(number);
+    return NULL;
+  }
+  return number;
+}
+
+BigInt *bigint_copy(const BigInt *number) {
+  if (number == NULL) {
+    return NULL;
+  } else {
+    BigInt *copy = calloc(1, sizeof(BigInt));
+    if (copy == NULL || !bigint_reserve(copy, number->size + 1)) {
+      free(copy);
+      return NULL;
+    }
+    memcpy(copy->limbs, number->limbs, number->size * sizeof(uint64_t));
+    copy->size = number->size;
+    return copy;
+  }
+}
+
+int bigint_set(BigInt *number, uint64_t value) {
+  if (number == NULL || !bigint_reserve(number, 1)) {
+    return 0;
+  } else {
+    number->limbs[0] = value;
+    number->size = (value != 0);
+    return 1;
+  }
+}
+
+// Returns -1, 0 or 1 if a is less than, equal to or greater than b.
+int bigint_compare(const BigInt *a, const BigInt *b) {
+  if (a->size != b->size) {
+    return (a->size > b->size) ? 1 : -1;
+  } else {
+    return bigint_compareN(a->limbs, b->limbs, a->size);
+  }
+}
+
+uint64_t bigint_bitLength(const BigInt *number) {
+  if (number == NULL || number->size == 0) {
+    return 0;
+  } else {
+    return number->size * 64 -
+           (uint64_t)__builtin_clzll(number->limbs[number->size - 1]);
+  }
+}
+
+int bigint_mulSmall(BigInt *number, uint64_t factor) {
+  if (number == NULL || !bigint_reserve(number, number->size + 1)) {
+    return 0;
+  } else {
+    uint64_t carry = 0;
+    for (uint64_t i = 0; i < number->size; i++) {
+      unsigned __int128 product =
+          (unsigned __int128)number->limbs[i] * factor + carry;
+      number->limbs[i] = (uint64_t)product;
+      carry = (uint64_t)(product >> 64);
+    }
+    number->limbs[number->size++] = carry;
+    bigint_normalize(number);
+    return 1;
+  }
+}
+
+// Multiplies the number by 2^bits.
+int bigint_shiftLeft(BigInt *number, uint64_t bits) {
+  uint64_t limbs = bits / 64;
+  unsigned shift = bits % 64;
+  if (number == NULL || !bigint_reserve(number, number->size + limbs + 1)) {
+    return 0;
+  } else if (number->size == 0) {
+    return 1;
+  } else {
+    number->limbs[number->size + limbs] = 0;
+    for (uint64_t i = number->size; i-- > 0;) {
+      uint64_t value = number->limbs[i];
+      if (shift) {
+        number->limbs[i + limbs + 1] |= value >> (64 - shift);
+      }
+      number->limbs[i + limbs] = value << shift;
+    }
+    memset(number->limbs, 0, limbs * sizeof(uint64_t));
+    number->size += limbs + 1;
+    bigint_normalize(number);
+    return 1;
+  }
+}
+
+// Sets result to a * b, result may be one of the factors. Returns 0 and leaves
+// result unchanged if the memory runs out.
+int bigint_mul(BigInt *result, const BigInt *a, const BigInt *b) {
+  if (result == NULL || a == NULL || b == NULL) {
+    return 0;
+  } else if (a->size == 0 || b->size == 0) {
+    result->size = 0;
+    return 1;
+  } else {
+    if (a->size < b->size) {
+      const BigInt *temp = a;
+      a = b;
+      b = temp;
+    }
+    uint64_t size = a->size + b->size;
+    uint64_t *limbs = malloc(size * sizeof(uint64_t));
+    if (limbs == NULL) {
+      return 0;
+    }
+    if (!bigint_mulLimbs(limbs, a->limbs, a->size, b->limbs, b->size)) {
+      free(limbs);
+      return 0;
+    }
+    free(result->limbs);
+    result->limbs = limbs;
+    result->capacity = size;
+    result->size = size;
+    bigint_normalize(result);
+    return 1;
+  }
+}
+
+// Sets result to a + b, result may be one of the operands.
+int bigint_add(BigInt *result, const BigInt *a, const BigInt *b) {
+  if (result == NULL || a == NULL || b == NULL) {
+    return 0;
+  } else {
+    if (a->size < b->size) {
+      const BigInt *temp = a;
+      a = b;
+      b = temp;
+    }
+    uint64_t an = a->size;
+    uint64_t bn = b->size;
+    if (!bigint_reserve(result, an + 1)) {
+      return 0;
+    }
+    // Every limb is read before the same limb of the result is written, so
+    // the operands may share their limbs with it.
+    uint64_t carry = bigint_addN(result->limbs, a->limbs, b->limbs, bn);
+    for (uint64_t i = bn; i < an; i++) {
+      uint64_t sum = a->limbs[i] + carry;
+      carry = sum < carry;
+      result->limbs[i] = sum;
+    }
+    result->limbs[an] = carry;
+    result->size = an + 1;
+    bigint_normalize(result);
+    return 1;
+  }
+}
+
+// Sets result to a - b, result may be one of the operands. Returns 0 if b is
+// greater than a, as the result can not be negative.
+int bigint_sub(BigInt *result, const BigInt *a, const BigInt *b) {
+  if (result == NULL || a == NULL || b == NULL || bigint_compare(a, b) < 0 ||
+      !bigint_reserve(result, a->size)) {
+    return 0;
+  } else {
+    uint64_t an = a->size;
+    uint64_t bn = b->size;
+    uint64_t borrow = bigint_subN(result->limbs, a->limbs, b->limbs, bn);
+    for (uint64_t i = bn; i < an; i++) {
+      uint64_t value = a->limbs[i];
+      result->limbs[i] = value - borrow;
+      borrow = value < borrow;
+    }
+    result->size = an;
+    bigint_normalize(result);
+    return 1;
+  }
+}
+
+// Hands the limbs over to the number, which frees its old ones.
+static void bigint_replace(BigInt *number, uint64_t *limbs, uint64_t size) {
+  free(number->limbs);
+  number->limbs = limbs;
+  number->capacity = size;
+  number->size = size;
+  bigint_normalize(number);
+}
+
+// Sets the n limbs of r to a shifted left by shift < 64 bits and returns the
+// bits shifted out.
+static uint64_t bigint_shiftLimbs(uint64_t *r, const uint64_t *a, uint64_t n,
+                                  unsigned shift) {
+  if (shift == 0) {
+    memmove(r, a, n * sizeof(uint64_t));
+    return 0;
+  }
+  uint64_t out = a[n - 1] >> (64 - shift);
+  for (uint64_t i = n - 1; i > 0; i--) {
+    r[i] = (a[i] << shift) | (a[i - 1] >> (64 - shift));
+  }
+  r[0] = a[0] << shift;
+  return out;
+}
+
+// Sets quotient to a / b and remainder to a % b, either may be NULL and both
+// may be one of the operands. Returns 0 if b is zero or the memory runs out.
+// Knuth's algorithm D estimates every limb of the quotient from the two
+// leading limbs of the remainder and the divisor, after b was shifted so its
+// top bit is set, which makes the estimate at most two too large.
+int bigint_divmod(BigInt *quotient, BigInt *remainder, const BigInt *a,
+                  const BigInt *b) {
+  if (a == NULL || b == NULL || b->size == 0) {
+    return 0;
+  }
+  uint64_t an = a->size;
+  uint64_t bn = b->size;
+  if (an < bn) {
+    uint64_t *rest = malloc((an + 1) * sizeof(uint64_t));
+    if (rest == NULL) {
+      return 0;
+    }
+    memcpy(rest, a->limbs, an * sizeof(uint64_t));
+    if (quotient != NULL) {
+      quotient->size = 0;
+    }
+    if (remainder != NULL) {
+      bigint_replace(remainder, rest, an);
+    } else {
+      free(rest);
+    }
+    return 1;
+  }
+  uint64_t *q = calloc(an - bn + 1, sizeof(uint64_t));
+  uint64_t *u = malloc((an + 1) * sizeof(uint64_t));
+  uint64_t *v = malloc(bn * sizeof(uint64_t));
+  if (q == NULL || u == NULL || v == NULL) {
+    free(q);
+    free(u);
+    free(v);
+    return 0;
+  }
+  if (bn == 1) {
+    // A single limb divisor needs one division per limb.
+    unsigned __int128 rest = 0;
+    for (uint64_t i = an; i-- > 0;) {
+      unsigned __int128 current = (rest << 64) | a->limbs[i];
+      q[i] = (uint64_t)(current / b->limbs[0]);
+      rest = current % b->limbs[0];
+    }
+    u[0] = (uint64_t)rest;
+  } else {
+    unsigned shift = (unsigned)__builtin_clzll(b->limbs[bn - 1]);
+    bigint_shiftLimbs(v, b->limbs, bn, shift);
+    u[an] = bigint_shiftLimbs(u, a->limbs, an, shift);
+    for (uint64_t j = an - bn + 1; j-- > 0;) {
+      unsigned __int128 top = ((unsigned __int128)u[j + bn] << 64) |
+                              u[j + bn - 1];
+      unsigned __int128 estimate = top / v[bn - 1];
+      unsigned __int128 rest = top % v[bn - 1];
+      while ((estimate >> 64) ||
+             estimate * v[bn - 2] > ((rest << 64) | u[j + bn - 2])) {
+        estimate--;
+        rest += v[bn - 1];
+        if (rest >> 64) {
+          break;
+        }
+      }
+      // Subtract estimate * v from the part of u at j.
+      uint64_t digit = (uint64_t)estimate;
+      uint64_t carry = 0;
+      uint64_t borrow = 0;
+      for (uint64_t i = 0; i < bn; i++) {
+        unsigned __int128 product = (unsigned __int128)digit * v[i] + carry;
+        carry = (uint64_t)(product >> 64);
+        uint64_t low = (uint64_t)product;
+        uint64_t value = u[i + j];
+        u[i + j] = value - low - borrow;
+        borrow = (value < low) || (value - low < borrow);
+      }
+      uint64_t value = u[j + bn];
+      u[j + bn] = value - carry - borrow;
+      if (value < carry || value - carry < borrow) {
+        // The estimate was one too large, add v back once.
+        digit--;
+        u[j + bn] += bigint_addN(u + j, u + j, v, bn);
+      }
+      q[j] = digit;
     }
-    if ((val < 0) || (val > 1) || val == -1) {
-      return;
+    // The remainder is left in the low limbs of u, shifted like b.
+    for (uint64_t i = 0; i < bn; i++) {
+      u[i] = (shift == 0) ? u[i]
+                          : (u[i] >> shift) | (u[i + 1] << (64 - shift));
     }
-    field[row][col] = val;
   }
-}
-
-// Create the linked list.
-LinkedList *llist_createList(void *data, size_t dataSize) {
-  if (data == NULL) {
-    return NULL;
+  free(v);
+  if (quotient != NULL) {
+    bigint_replace(quotient, q, an - bn + 1);
   } else {
-    LinkedList *list = (LinkedList *)malloc(sizeof(LinkedList));
-    list->front = (node *)malloc(sizeof(node));
-    list->back = list->front;
-    list->globalId = 0;
-
-    // Allocate the data pointer.
-    list->front->data = malloc(dataSize);
-    memcpy(list->front->data, data, dataSize);
+    free(q);
+  }
+  if (remainder != NULL) {
+    bigint_replace(remainder, u, bn);
+  } else {
+    free(u);
+  }
+  return 1;
+}
 
-    list->front->dataSize = dataSize;
-    list->front->id = list->globalId;
-    list->front->next = NULL;
+// Part of the product tree of a factorial, the product is computed by the
+// thread that gets the job. success is 0 if the memory ran out, then the
+// product holds no limbs.
+typedef struct {
+  const uint64_t *factors;
+  uint64_t count;
+  uint32_t threads;
+  BigInt product;
+  int success;
+} BigintTreeJob;
 
-    return list;
+static void *bigint_productTree(void *argument) {
+  BigintTreeJob *job = argument;
+  if (job->count <= BIGINT_FACTORIAL_LEAF) {
+    job->success = bigint_set(&job->product, 1);
+    for (uint64_t i = 0; job->success && i < job->count; i++) {
+      job->success = bigint_mulSmall(&job->product, job->factors[i]);
+    }
+    if (!job->success) {
+      free(job->product.limbs);
+      job->product = (BigInt){0, 0, NULL};
+    }
+    return NULL;
+  }
+  // The halves hold about the same amount of bits, so the product at the
+  // top multiplies two numbers of the same size.
+  uint64_t half = job->count / 2;
+  BigintTreeJob left = {job->factors, half, job->threads / 2, {0, 0, NULL}, 0};
+  BigintTreeJob right = {job->factors + half, job->count - half,
+                         job->threads - left.threads, {0, 0, NULL}, 0};
+  pthread_t worker;
+  int spawned = left.threads > 0 && job->count >= BIGINT_FACTORIAL_PARALLEL &&
+                pthread_create(&worker, NULL, bigint_productTree, &left) == 0;
+  if (!spawned) {
+    bigint_productTree(&left);
   }
+  bigint_productTree(&right);
+  if (spawned) {
+    pthread_join(worker, NULL);
+  }
+  job->success = left.success && right.success &&
+                 bigint_mul(&left.product, &left.product, &right.product);
+  free(right.product.limbs);
+  if (!job->success) {
+    free(left.product.limbs);
+    left.product = (BigInt){0, 0, NULL};
+  }
+  job->product = left.product;
+  return NULL;
 }
 
-uint64_t llist_appendItem(LinkedList *list, void *data, uint64_t dataSize) {
-  node *temp = NULL;
-  node *front = list->front;
-  uint64_t id = ++list->globalId;
-  if (front == NULL) {
-    list->front = (node *)malloc(sizeof(node));
-    list->back = list->front;
-    list->globalId = 0;
+// Calculates n! exactly. The odd parts of 2, ..., n are packed into as few
+// words as possible and multiplied by a balanced product tree, whose subtrees
+// are split between up to threads threads (0 for one per core). The powers of
+// two are shifted in at the end. Returns NULL if the memory runs out.
+BigInt *bigint_factorial(uint64_t n, uint32_t threads) {
+  Uint64Array *factors = uint64arr_initialize(n / 4 + 16);
+  if (factors == NULL) {
+    return NULL;
+  }
+  int success = 1;
+  uint64_t word = 1;
+  uint64_t shift = 0;
+  for (uint64_t k = 2; k <= n; k++) {
+    unsigned zeros = (unsigned)__builtin_ctzll(k);
+    uint64_t odd = k >> zeros;
+    shift += zeros;
+    unsigned __int128 packed = (unsigned __int128)word * odd;
+    if (packed >> 64) {
+      success &= uint64arr_add(factors, word);
+      word = odd;
+    } else {
+      word = (uint64_t)packed;
+    }
+  }
+  success &= uint64arr_add(factors, word);
+  if (!success) {
+    uint64arr_delete(&factors);
+    return NULL;
+  }
 
-    // Allocate the data pointer.
-    list->front->data = malloc((size_t)dataSize);
-    memcpy(list->front->data, data, dataSize);
+  BigintTreeJob job = {factors->data, factors->size,
+                       algo_threadCount(threads), {0, 0, NULL}, 0};
+  bigint_productTree(&job);
+  uint64arr_delete(&factors);
+  BigInt *result = job.success ? malloc(sizeof(BigInt)) : NULL;
+  if (result == NULL) {
+    free(job.product.limbs);
+    return NULL;
+  }
+  *result = job.product;
+  if (!bigint_shiftLeft(result, shift)) {
+    bigint_delete(&result);
+    return NULL;
+  }
+  return result;
+}
 
-    list->front->dataSize = dataSize;
-    list->front->id = list->globalId;
-    list->front->next = NULL;
-  } else {
-    // Allocation and declaration of the list item at the temporary pointer
-    // temp.
-    temp = (node *)malloc(sizeof(node));
-    temp->id = id;
-    temp->next = NULL;
-    temp->data = malloc((size_t)dataSize);
-    memcpy(temp->data, data, dataSize);
+// Calculates n! with one multiplication by a word per factor. Returns NULL if
+// the memory runs out.
+BigInt *bigint_factorialNaive(uint64_t n) {
+  BigInt *result = bigint_create(1);
+  for (uint64_t k = 2; result != NULL && k <= n; k++) {
+    if (!bigint_mulSmall(result, k)) {
+      bigint_delete(&result);
+    }
+  }
+  return result;
+}
 
-    list->back->next = temp;
-    list->back = temp;
-    temp = NULL;
+// Returns the decimal digits of the number, which the caller has to free. Every
+// limb costs a division of the remaining number, so it takes quadratic time.
+char *bigint_toString(const BigInt *number) {
+  if (number == NULL) {
+    return NULL;
   }
-  return id;
+  const uint64_t base = 10000000000000000000ULL;
+  uint64_t length = number->size * 20 + 2;
+  char *text = malloc(length);
+  uint64_t *limbs = malloc((number->size + 1) * sizeof(uint64_t));
+  memcpy(limbs, number->limbs, number->size * sizeof(uint64_t));
+  uint64_t size = number->size;
+  uint64_t position = length - 1;
+  text[position] = '\0';
+  while (size > 0) {
+    unsigned __int128 remainder = 0;
+    for (uint64_t i = size; i-- > 0;) {
+      unsigned __int128 current = (remainder << 64) | limbs[i];
+      limbs[i] = (uint64_t)(current / base);
+      remainder = current % base;
+    }
+    while (size > 0 && limbs[size - 1] == 0) {
+      size--;
+    }
+    // Every chunk but the leading one has 19 digits.
+    uint64_t digits = (uint64_t)remainder;
+    for (int i = 0; i < 19 && (size > 0 || digits > 0); i++) {
+      text[--position] = (char)('0' + digits % 10);
+      digits /= 10;
+    }
+  }
+  if (position == length - 1) {
+    text[--position] = '0';
+  }
+  memmove(text, text + position, length - position);
+  free(limbs);
+  return text;
 }
 
-int llist_printList(LinkedList *list, void (*outputData)(node *)) {
-  int position = 0;
-  node *itrVar = list->front;
-  if (itrVar == NULL) {
-    fprintf(stderr, "The list is empty!\n");
-    return 0;
+void bigint_delete(BigInt **number) {
+  if (number == NULL || *number == NULL) {
+    return;
   } else {
-    while (itrVar != NULL) {
-      printf("\nPosition: %d,  \n", position++);
-      printf("ID: %d\n", itrVar->id);
-      outputData(itrVar);
-      itrVar = itrVar->next;
-    }
+    free((*number)->limbs);
+    free(*number);
+    *number = NULL;
   }
-  itrVar = NULL;
-  return 1;
 }
 
-node *llist_findItem(LinkedList *list, uint32_t id) {
-  node *itrVar = list->front;
-  while (itrVar != NULL) {
-    if (itrVar->id == id) {
-      return itrVar;
+// Prints the time to calculate n! for n = 1000, 10000, ... up to maxN with one
+// multiplication per factor, which is left out above 10^5, and with the
+// product tree on one and on maxThreads threads (0 for one per core).
+void bigint_benchmark(uint64_t maxN, uint32_t maxThreads) {
+  maxThreads = algo_threadCount(maxThreads);
+  printf("%-10s %-12s %-12s %-12s %-12s %-6s\n", "n", "bits", "naive s",
+         "tree s", "threads s", "check");
+  for (uint64_t n = 1000; n <= maxN; n *= 10) {
+    double times[3] = {0, 0, 0};
+    BigInt *naive = NULL;
+    double start = algo_seconds();
+    if (n <= 100000) {
+      naive = bigint_factorialNaive(n);
+      times[0] = algo_seconds() - start;
+    }
+    start = algo_seconds();
+    BigInt *tree = bigint_factorial(n, 1);
+    times[1] = algo_seconds() - start;
+    start = algo_seconds();
+    BigInt *parallel = bigint_factorial(n, maxThreads);
+    times[2] = algo_seconds() - start;
+    int correct = bigint_compare(tree, parallel) == 0 &&
+                  (naive == NULL || bigint_compare(tree, naive) == 0);
+    printf("%-10llu %-12llu ", (unsigned long long)n,
+           (unsigned long long)bigint_bitLength(tree));
+    if (naive != NULL) {
+      printf("%-12.4f ", times[0]);
     } else {
-      itrVar = itrVar->next;
+      printf("%-12s ", "-");
     }
+    printf("%-12.4f %-12.4f %-6s\n", times[1], times[2],
+           correct ? "ok" : "FAIL");
+    bigint_delete(&naive);
+    bigint_delete(&tree);
+    bigint_delete(&parallel);
   }
-  return NULL;
 }
-void llist_deleteList(LinkedList *list, void (*freefunc)(void *data)) {
-  // Initializing the variables used for the iteration and the deletion.
-  node *itrVar = list->front;
-  node *freeVar = NULL;
 
-  while (itrVar != NULL) {
-    freeVar = itrVar;
-    itrVar = itrVar->next;
-    freefunc(freeVar->data);
-    free(freeVar);
-  };
-  // Sets the pointers front and back to point to nothing as the final step.
-  list->back = NULL;
-  list->front = NULL;
-  list->globalId = 0;
+// Prints the time of one multiplication of two random numbers of n limbs for
+// sizes from 8 limbs up to maxLimbs, with each method at the top level and
+// the method for the size below it, next to the dispatch of bigint_mul. The
+// crossovers of the columns are where the thresholds belong. Schoolbook is
+// left out above 4096 limbs.
+void bigint_mulBenchmark(uint64_t maxLimbs) {
+  const char *names[] = {"school us", "karatsuba us", "toom3 us", "ntt us",
+                         "auto us"};
+  uint64_t seed = 0x9E3779B97F4A7C15ULL;
+  printf("%-10s", "limbs");
+  for (int method = 0; method < 5; method++) {
+    printf(" %-13s", names[method]);
+  }
+  printf(" %-6s\n", "check");
+  // The sizes grow by factors of 1.5 and 4 / 3 in turn.
+  for (uint64_t n = 8; n <= maxLimbs;
+       n = (n % 3 == 0) ? n / 3 * 4 : n / 2 * 3) {
+    uint64_t *a = malloc(n * sizeof(uint64_t));
+    uint64_t *b = malloc(n * sizeof(uint64_t));
+    uint64_t *products = malloc(5 * 2 * n * sizeof(uint64_t));
+    uint64_t *scratch = malloc(bigint_karatsubaScratch(n) * sizeof(uint64_t));
+    for (uint64_t i = 0; i < n; i++) {
+      a[i] = algo_random(&seed);
+      b[i] = algo_random(&seed);
+    }
+    printf("%-10llu", (unsigned long long)n);
+    int measured[5] = {1, 1, 1, 1, 1};
+    int correct = 1;
+    for (int method = 0; method < 5; method++) {
+      uint64_t *r = products + method * 2 * n;
+      if ((method == 0 && n > 4096) || (method == 2 && n < 9)) {
+        measured[method] = 0;
+        printf(" %-13s", "-");
+        continue;
+      }
+      // Repeats the product until the time is large enough to measure.
+      uint64_t rounds = 0;
+      double start = algo_seconds();
+      double time;
+      do {
+        switch (method) {
+        case 0:
+          bigint_mulBasecase(r, a, n, b, n);
+          break;
+        case 1:
+          bigint_karatsuba(r, a, b, n, scratch);
+          break;
+        case 2:
+          bigint_toom3(r, a, b, n);
+          break;
+        case 3:
+          bigint_mulNtt(r, a, n, b, n);
+          break;
+        default:
+          bigint_mulLimbs(r, a, n, b, n);
+          break;
+        }
+        rounds++;
+        time = algo_seconds() - start;
+      } while (time < 0.02);
+      printf(" %-13.2f", time * 1e6 / (double)rounds);
+    }
+    // The automatic product ran last and serves as the reference.
+    for (int method = 0; method < 4; method++) {
+      correct &= !measured[method] ||
+                 memcmp(products + method * 2 * n, products + 8 * n,
+                        2 * n * sizeof(uint64_t)) == 0;
+    }
+    printf(" %-6s\n", correct ? "ok" : "FAIL");
+    free(a);
+    free(b);
+    free(products);
+    free(scratch);
+  }
 }
 
-void llist_deleteItem(LinkedList *list, uint32_t id,
-                      void (*freefunc)(void *data)) {
-  node *temp = NULL, *itrVar = NULL;
-  // If the id is not existing or
-  if (list->front == NULL || id > list->globalId || id < list->front->id) {
-    // end the function.
-    return;
-    // If the id is in the front.
-  } else if (list->front->id == id) {
-    temp = list->front;
-    list->front = list->front->next;
-    freefunc(temp->data);
-    free(temp);
+// Modular factorials and binomial coefficients:
 
-    // If the id is in the back.
-  } else if (list->back->id == id) {
-    itrVar = list->front;
-    while (itrVar->next != NULL) {
-      temp = itrVar;
-      itrVar = itrVar->next;
-    }
-    list->back = temp;
-    temp->next = NULL;
-    freefunc(itrVar->data);
-    free(itrVar);
-    // If the id is somewhere between front and back.
+// Products of residues below 2^32 fit into 64 bits, whose division is much
+// cheaper than the one of 128 bits.
+static uint64_t modcomb_mul(uint64_t a, uint64_t b, uint64_t modulus) {
+  if (modulus <= UINT32_MAX) {
+    return a * b % modulus;
   } else {
-    itrVar = list->front;
-    while (itrVar->id != id) {
-      temp = itrVar;
-      itrVar = itrVar->next;
-    }
-    temp->next = itrVar->next;
-    freefunc(itrVar->data);
-    free(itrVar);
+    return (uint64_t)((unsigned __int128)a * b % modulus);
   }
-  temp = NULL;
-  itrVar = NULL;
 }
 
-// Appends a linked list to the end of the second linked list.
-int llist_merge(LinkedList *start, LinkedList *appendedList) {
-  if (start == NULL) {
-    return 0;
-  } else {
-    start->back->next = appendedList->front;
-    return 1;
+static uint64_t modcomb_pow(uint64_t base, uint64_t exponent,
+                            uint64_t modulus) {
+  uint64_t result = 1 % modulus;
+  while (exponent) {
+    if (exponent & 1) {
+      result = modcomb_mul(result, base, modulus);
+    }
+    base = modcomb_mul(base, base, modulus);
+    exponent >>= 1;
   }
+  return result;
 }
 
-Stack *stack_initialize(void *data, size_t dataSize) {
-  if (data == NULL) {
+// Creates the tables of n! and 1/n! modulo the prime for n = 0, ..., limit.
+// Only one modular inverse is needed, the other inverse factorials follow
+// from 1/(n - 1)! = n / n!. The tables stop at p - 1, as every larger
+// factorial is a multiple of p. Returns NULL if the modulus is not prime.
+ModComb *modcomb_create(uint64_t limit, uint64_t prime) {
+  if (!prime_isPrime64(prime)) {
     return NULL;
+  } else {
+    if (limit > prime - 1) {
+      limit = prime - 1;
+    }
+    ModComb *comb = malloc(sizeof(ModComb));
+    if (comb == NULL) {
+      return NULL;
+    }
+    comb->prime = prime;
+    comb->limit = limit;
+    comb->factorials = malloc((limit + 1) * sizeof(uint64_t));
+    comb->inverseFactorials = malloc((limit + 1) * sizeof(uint64_t));
+    if (comb->factorials == NULL || comb->inverseFactorials == NULL) {
+      modcomb_delete(&comb);
+      return NULL;
+    }
+    comb->factorials[0] = 1;
+    for (uint64_t i = 1; i <= limit; i++) {
+      comb->factorials[i] = modcomb_mul(comb->factorials[i - 1], i, prime);
+    }
+    // Fermat's little theorem gives the inverse of the last factorial.
+    comb->inverseFactorials[limit] =
+        modcomb_pow(comb->factorials[limit], prime - 2, prime);
+    for (uint64_t i = limit; i > 0; i--) {
+      comb->inverseFactorials[i - 1] =
+          modcomb_mul(comb->inverseFactorials[i], i, prime);
+    }
+    return comb;
   }
-  Stack *stack = malloc(sizeof(Stack));
-  stack->dataSize = dataSize;
-  stack->next = NULL;
-
-  stack->data = malloc(dataSize);
-  memcpy(stack->data, data, dataSize);
-
-  return stack;
 }
 
-uint32_t stack_push(Stack **stack, void *data, size_t dataSize) {
-  if (stack == NULL || data == NULL || *stack == NULL) {
+// Returns n! modulo the prime. Past the table the missing factors are
+// multiplied one by one.
+uint64_t modcomb_factorial(ModComb *comb, uint64_t n) {
+  if (n >= comb->prime) {
     return 0;
+  } else if (n <= comb->limit) {
+    return comb->factorials[n];
   } else {
-    Stack *temp = malloc(sizeof(Stack));
-    temp->dataSize = dataSize;
-    temp->data = malloc(dataSize);
-    memcpy(temp->data, data, dataSize);
-
-    temp->next = *stack;
-    *stack = temp;
-
-    return 1;
+    uint64_t result = comb->factorials[comb->limit];
+    for (uint64_t i = comb->limit + 1; i <= n; i++) {
+      result = modcomb_mul(result, i, comb->prime);
+    }
+    return result;
   }
 }
-Stack *stack_pop(Stack **stack) {
-  if (stack == NULL) {
-    return NULL;
+
+// Returns C(n, k) modulo the prime for n < prime with three lookups.
+// UINT64_MAX, which is never a residue, flags an n past the tables, the
+// product of min(k, n - k) factors would take up to p steps.
+static uint64_t modcomb_binomialSmall(ModComb *comb, uint64_t n, uint64_t k) {
+  if (k > n) {
+    return 0;
+  } else if (n > comb->limit) {
+    return UINT64_MAX;
   } else {
-    Stack *temp = *stack;
-    *stack = (*stack)->next;
-    return temp;
+    return modcomb_mul(modcomb_mul(comb->factorials[n],
+                                   comb->inverseFactorials[k], comb->prime),
+                       comb->inverseFactorials[n - k], comb->prime);
   }
 }
 
-uint32_t stack_empty(Stack **stack) { return *stack == NULL; }
-
-Stack *stack_top(Stack *stack) {
-  if (stack == NULL) {
-    return NULL;
-  } else {
-    return stack;
+// Returns C(n, k) modulo the prime with Lucas' theorem: the coefficient is
+// the product of the coefficients of the base p digits of n and k. With
+// tables up to p - 1 every digit takes O(1). Returns UINT64_MAX if a digit of
+// n lies past the tables.
+uint64_t modcomb_lucas(ModComb *comb, uint64_t n, uint64_t k) {
+  uint64_t result = 1;
+  while (k > 0 && result != 0) {
+    uint64_t digit =
+        modcomb_binomialSmall(comb, n % comb->prime, k % comb->prime);
+    if (digit == UINT64_MAX) {
+      return UINT64_MAX;
+    }
+    result = modcomb_mul(result, digit, comb->prime);
+    n /= comb->prime;
+    k /= comb->prime;
   }
+  return result;
 }
 
-// Create a new doubly linked list.
-DLinkedList *dllist_initialization(void *data, size_t dataSize) {
-  if (data == NULL) {
-    return NULL;
+// Returns C(n, k) modulo the prime, 0 if k > n and UINT64_MAX if the tables
+// are too small for the query, see modcomb_lucas.
+uint64_t modcomb_binomial(ModComb *comb, uint64_t n, uint64_t k) {
+  if (k > n) {
+    return 0;
+  } else if (n <= comb->limit) {
+    return modcomb_binomialSmall(comb, n, k);
   } else {
-    // Allocates the space for the constant container of the list.S
-    DLinkedList *list = malloc(sizeof(DLinkedList));
-    list->dataSize = dataSize;
-    list->size = 1;
-    // Allocates the space for the node.
-    list->head = malloc(sizeof(DLNode));
-    list->head->prev = NULL;
-    list->head->next = NULL;
-
-    // Allocate the space for the data.
-    list->head->data = malloc(dataSize);
-    // Copy the data into the space that was allocated in the previous line.
-    memcpy(list->head->data, data, dataSize);
-
-    list->tail = list->head;
-    return list;
+    return modcomb_lucas(comb, n, k);
   }
 }
 
-// Adds a new element to the head of the llist.
-int dllist_push(DLinkedList *list, void *data, size_t dataSize) {
-  if (list == NULL || data == NULL) {
-    return 0;
-  } else {
-    // Allocate the space for the new node
-    DLNode *node = malloc(sizeof(DLNode));
-    node->data = malloc(dataSize);
-    // Copy the data into the new node.
-    memcpy(node->data, data, list->dataSize);
-    if (list->size == 0) {
-      list->head = node;
-      list->tail = node;
+// Sets results[i] to C(n[i], k[i]) modulo the prime for count queries.
+void modcomb_binomialBatch(ModComb *comb, const uint64_t *n,
+                           const uint64_t *k, uint64_t *results,
+                           size_t count) {
+  uint64_t prime = comb->prime;
+  const uint64_t *factorials = comb->factorials;
+  const uint64_t *inverse = comb->inverseFactorials;
+  for (size_t i = 0; i < count; i++) {
+    if (k[i] <= n[i] && n[i] <= comb->limit) {
+      results[i] = modcomb_mul(
+          modcomb_mul(factorials[n[i]], inverse[k[i]], prime),
+          inverse[n[i] - k[i]], prime);
     } else {
-      // Set the next node after the current tail to be the new node.
-      list->tail->next = node;
-      // Set the pointer prev of the new node to point to the old tail.
-      node->prev = list->tail;
-      // Set the tail variable to the new node, as it is now the new tail.
-      list->tail = node;
+      results[i] = modcomb_binomial(comb, n[i], k[i]);
     }
-    // Increase the size of the list before returning to the caller.
-    list->size++;
-    return 1;
   }
 }
-// Removes the element from the tail.
-DLNode *dllist_pop(DLinkedList *list) {
-  // Error checking.
-  if (list == NULL || list->size == 0) {
-    return NULL;
+
+void modcomb_delete(ModComb **comb) {
+  if (comb == NULL || *comb == NULL) {
+    return;
   } else {
-    // Sets the temporary variable to point to the head of the list.
-    DLNode *temp = list->head;
-    // Case 1: the list has two members.
-    if (list->size == 1) {
-      list->head = NULL;
-      list->tail = NULL;
-      // Case 2: the list has > 2 members.
-    } else {
-      list->head = temp->next;
-      list->head->prev = NULL;
-      temp->next = NULL;
-    }
-    list->size--;
-    return temp;
+    free((*comb)->factorials);
+    free((*comb)->inverseFactorials);
+    free(*comb);
+    *comb = NULL;
   }
 }
 
-uint32_t dllist_size(DLinkedList *list) { return list->size; }
+// Prints the time per query of C(n, k) modulo 10^9 + 7 for random n up to
+// limit, computed from scratch with a product and a modular inverse, with
+// the tables one by one and as a batch, and the time to build the tables.
+// The second part answers queries with n up to 10^18 modulo 10007 with
+// Lucas' theorem.
+void modcomb_benchmark(uint64_t limit, uint64_t queries) {
+  const uint64_t prime = 1000000007ULL;
+  uint64_t seed = 0x2545F4914F6CDD1DULL;
+  uint64_t *n = calloc(queries, sizeof(uint64_t));
+  uint64_t *k = calloc(queries, sizeof(uint64_t));
+  uint64_t *results = malloc(3 * queries * sizeof(uint64_t));
+  if (n == NULL || k == NULL || results == NULL) {
+    free(n);
+    free(k);
+    free(results);
+    return;
+  }
+  for (uint64_t i = 0; i < queries; i++) {
+    n[i] = algo_random(&seed) % (limit + 1);
+    k[i] = algo_random(&seed) % (n[i] + 1);
+  }
 
-int dllist_isEmpty(DLinkedList *list) { return dllist_size(list); }
+  double start = algo_seconds();
+  ModComb *comb = modcomb_create(limit, prime);
+  double build = algo_seconds() - start;
 
-// Initializes a new queue with the data in the parameter.
-Queue *queue_initialize(void *data, size_t dataSize) {
-  return dllist_initialization(data, dataSize);
-}
+  // From scratch every query multiplies min(k, n - k) factors.
+  uint64_t naiveQueries = (queries < 1000) ? queries : 1000;
+  start = algo_seconds();
+  for (uint64_t i = 0; i < naiveQueries; i++) {
+    uint64_t small = (k[i] < n[i] - k[i]) ? k[i] : n[i] - k[i];
+    uint64_t numerator = 1;
+    uint64_t denominator = 1;
+    for (uint64_t j = 0; j < small; j++) {
+      numerator = modcomb_mul(numerator, n[i] - j, prime);
+      denominator = modcomb_mul(denominator, j + 1, prime);
+    }
+    results[i] = modcomb_mul(numerator,
+                             modcomb_pow(denominator, prime - 2, prime), prime);
+  }
+  double naive = (algo_seconds() - start) / (double)naiveQueries;
 
-// Enqueues a new item at the start of the queue.
-int queue_enqueue(Queue *queue, void *data, size_t dataSize) {
-  return dllist_push(queue, data, dataSize);
-}
+  start = algo_seconds();
+  for (uint64_t i = 0; i < queries; i++) {
+    results[queries + i] = modcomb_binomial(comb, n[i], k[i]);
+  }
+  double single = (algo_seconds() - start) / (double)queries;
 
-// Dequeues an item from the end of the queue.
-DLNode *queue_dequeue(Queue *queue) { return dllist_pop(queue); }
+  start = algo_seconds();
+  modcomb_binomialBatch(comb, n, k, results + 2 * queries, queries);
+  double batch = (algo_seconds() - start) / (double)queries;
 
-// Exexcutes a simple xor swap on the variables a and b.
-void xorswap(int *a, int *b) {
-  // Set the value of a to the xor of a and b
-  *a = *a ^ *b;
-  // Set the value of b to the xor of itself and the xor of the new a and the
-  // previous b.
-  *b = *a ^ *b;
-  // xor the new values of a and b again.
-  *a = *a ^ *b;
-}
+  int correct = memcmp(results, results + queries,
+                       naiveQueries * sizeof(uint64_t)) == 0 &&
+                memcmp(results + queries, results + 2 * queries,
+                       queries * sizeof(uint64_t)) == 0;
+  printf("%-12s %-12s %-12s %-12s %-12s %-6s\n", "limit", "build ms",
+         "naive ns", "table ns", "batch ns", "check");
+  printf("%-12llu %-12.3f %-12.1f %-12.1f %-12.1f %-6s\n",
+         (unsigned long long)limit, build * 1e3, naive * 1e9, single * 1e9,
+         batch * 1e9, correct ? "ok" : "FAIL");
+  modcomb_delete(&comb);
 
-// Recursively calculates the factorial of the number in the argument.
-uint64_t factorial(uint64_t number) {
-  if (number == 0 || number == 1) {
-    return 1;
-  } else {
-    return factorial(number - 1) * number;
+  // Lucas against the definition C(n, k) = C(n - 1, k - 1) + C(n - 1, k).
+  comb = modcomb_create(UINT64_MAX, 10007);
+  correct = 1;
+  for (uint64_t a = 1; a < 200; a++) {
+    for (uint64_t b = 1; b < a; b++) {
+      uint64_t sum = modcomb_lucas(comb, a * 9973 - 1, b * 9973 - 1) +
+                     modcomb_lucas(comb, a * 9973 - 1, b * 9973);
+      correct &= modcomb_lucas(comb, a * 9973, b * 9973) == sum % 10007;
+    }
   }
-}
-// Calculate the factorial of the number in the argument with iteration.
-uint64_t factorialNR(uint64_t number) {
-  uint64_t fact = 1;
-  for (uint64_t i = 2; i <= number; i++) {
-    fact *= i;
+  start = algo_seconds();
+  uint64_t checksum = 0;
+  for (uint64_t i = 0; i < queries; i++) {
+    uint64_t big = algo_random(&seed) % 1000000000000000000ULL;
+    checksum += modcomb_binomial(comb, big, algo_random(&seed) % (big + 1));
   }
-  return fact;
+  double lucas = (algo_seconds() - start) / (double)queries;
+  printf("lucas mod 10007: %.1f ns per query (checksum %llu) %s\n",
+         lucas * 1e9, (unsigned long long)checksum, correct ? "ok" : "FAIL");
+  modcomb_delete(&comb);
+  free(n);
+  free(k);
+  free(results);
 }
 
 static void dynarr_deltefuncioninteger(void **data) { free(data); }
@@ -806,9 +7640,6 @@ static void printfunc(DynamicArray *array, int length) {
     printf("%d ", *((int *)dynarr_at(array, i)));
   printf("]\n");
 }
-int main(void) {
-  int integers[] = {0, 1, 2, 3, 4, 5, 6, 7};
-}
 // https://en.wikipedia.org/wiki/Karatsuba_algorithm#:~:text=The%20Karatsuba%20algorithm%20was%20the,faster%2C%20for%20sufficiently%20large%20n.
 // https://en.wikipedia.org/wiki/Sch%C3%B6nhage%E2%80%93Strassen_algorithm
 // http://www.cs.cornell.edu/courses/cs3410/2019sp/labs/lab10/
\ No newline at end of file
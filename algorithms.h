@@ -6,6 +6,8 @@
 #define ALGORITHMS_H
 
 #include "importantIncludes.h"
+#include "instrumentation.h"
+#include "typedArray.h"
 
 // Just copied this from stack overflow
 // https://stackoverflow.com/questions/47981/how-do-you-set-clear-and-toggle-a-single-bit/263738#263738https://stackoverflow.com/questions/47981/how-do-you-set-clear-and-toggle-a-single-bit/263738#263738
@@ -24,26 +26,114 @@
 #define BITMASK_CHECK_ANY(x, y) ((x) & (y))
 
 // Data structures:
+
+// Source of the memory of the nodes of a container. free gets the size that
+// was passed to alloc, reset releases every block at once and may be NULL.
+// Containers without an allocator use malloc and free.
+typedef struct Allocator {
+  void *(*alloc)(void *context, size_t size);
+  void (*free)(void *context, void *block, size_t size);
+  void (*reset)(void *context);
+  void *context;
+} Allocator;
+
+// Header of a block that was too large for the slabs of a pool.
+typedef struct PoolLargeBlock {
+  struct PoolLargeBlock *prev;
+  struct PoolLargeBlock *next;
+} PoolLargeBlock;
+
+// Pool of equally sized blocks carved out of large slabs. Freed blocks go to
+// a free list, a reset hands out the slabs from the start again. Blocks larger
+// than blockSize fall back to malloc.
 typedef struct {
+  // Pass &pool->allocator to the containers.
+  Allocator allocator;
+  size_t blockSize;
+  size_t blocksPerSlab;
+  uint8_t **slabs;
+  size_t slabCount;
+  size_t slabCapacity;
+  size_t currentSlab;
+  uint8_t *bump;
+  uint8_t *bumpEnd;
+  void *freeList;
+  PoolLargeBlock *large;
+} PoolAllocator;
+
+typedef struct node {
   uint64_t id;
   void *data;
   uint64_t dataSize;
   struct node *next;
 } node;
 
+// Target size in bytes of a node of an unrolled list including its header.
+#ifndef ULLIST_NODE_BYTES
+#define ULLIST_NODE_BYTES 256
+#endif
+
+// Node of an unrolled list, the elements first to first + count - 1 of data
+// are in use.
+typedef struct UnrolledNode {
+  struct UnrolledNode *prev;
+  struct UnrolledNode *next;
+  uint64_t first;
+  uint64_t count;
+  unsigned char data[];
+} UnrolledNode;
+
+// Doubly linked list with up to nodeCapacity elements of dataSize bytes per
+// node, so a scan walks mostly over contiguous memory.
+typedef struct {
+  uint64_t size;
+  size_t dataSize;
+  uint64_t nodeCapacity;
+  UnrolledNode *head;
+  UnrolledNode *tail;
+} UnrolledList;
+
+// Position of an iteration over an unrolled list.
+typedef struct {
+  UnrolledNode *node;
+  uint64_t index;
+  size_t dataSize;
+} UnrolledIterator;
+
+// Slot of the id index of a LinkedList, item is NULL for an empty slot.
+typedef struct {
+  uint64_t id;
+  node *item;
+  // The node before item, NULL for the front.
+  node *prev;
+} LlistIndexEntry;
+
+// Open addressing hash table with linear probing from the ids to the nodes.
+// The capacity is a power of two and at least twice the count.
+typedef struct {
+  LlistIndexEntry *entries;
+  uint64_t capacity;
+  uint64_t count;
+} LlistIndex;
+
 typedef struct {
   uint64_t globalId;
   node *back;
   node *front;
+  // If set, the nodes and their data share one block from the allocator.
+  Allocator *allocator;
+  // Optional id index, NULL unless enabled with llist_enableIndex.
+  LlistIndex *index;
 } LinkedList;
 
-typedef struct {
+typedef struct Stack {
   void *data;
   size_t dataSize;
   struct Stack *next;
+  Allocator *allocator;
 } Stack;
 
-typedef struct {
+typedef struct DLNode {
   void *data;
   struct DLNode *prev;
   struct DLNode *next;
@@ -54,10 +144,221 @@ typedef struct dllist {
   uint32_t size;
   DLNode *head;
   DLNode *tail;
+  // If set, the nodes and their data share one block from the allocator.
+  Allocator *allocator;
 } DLinkedList;
 
 typedef DLinkedList Queue;
 
+// Nodes with the data stored inline behind the header instead of behind a
+// pointer, so a traversal touches one block per element. The data of all
+// nodes of a container has the dataSize of the container.
+typedef struct InlineNode {
+  uint64_t id;
+  struct InlineNode *next;
+  unsigned char data[];
+} InlineNode;
+
+typedef struct {
+  uint64_t globalId;
+  uint64_t size;
+  size_t dataSize;
+  InlineNode *front;
+  InlineNode *back;
+  Allocator *allocator;
+} InlineLinkedList;
+
+typedef struct InlineDLNode {
+  struct InlineDLNode *prev;
+  struct InlineDLNode *next;
+  unsigned char data[];
+} InlineDLNode;
+
+typedef struct {
+  uint64_t size;
+  size_t dataSize;
+  InlineDLNode *head;
+  InlineDLNode *tail;
+  Allocator *allocator;
+} InlineDLinkedList;
+
+typedef struct InlineStackNode {
+  struct InlineStackNode *next;
+  // Keeps the data 16 byte aligned like the other inline nodes.
+  uint64_t padding;
+  unsigned char data[];
+} InlineStackNode;
+
+typedef struct {
+  uint64_t size;
+  size_t dataSize;
+  InlineStackNode *top;
+  Allocator *allocator;
+} InlineStack;
+
+// Double ended queue in one contiguous ring buffer. The capacity is a power
+// of two, element i is stored at slot (head + i) & (capacity - 1). It serves
+// as a queue (pushBack and popFront) and as a stack (pushBack and popBack)
+// without an allocation per element.
+typedef struct {
+  uint64_t head;
+  uint64_t size;
+  uint64_t capacity;
+  size_t dataSize;
+  unsigned char *data;
+} RingDeque;
+
+// Size of a cache line. Fields that different threads write are kept this far
+// apart, so they do not invalidate each other's caches.
+#ifndef ALGO_CACHE_LINE
+#define ALGO_CACHE_LINE 64
+#endif
+
+// Bounded lock-free queue for any amount of producer and consumer threads.
+// Every cell carries a sequence number that tells whether it is ready for the
+// enqueue or the dequeue of a position, so the threads only contend on the
+// two position counters.
+typedef struct {
+  _Alignas(ALGO_CACHE_LINE) atomic_uint_fast64_t enqueuePosition;
+  _Alignas(ALGO_CACHE_LINE) atomic_uint_fast64_t dequeuePosition;
+  _Alignas(ALGO_CACHE_LINE) uint64_t mask;
+  size_t dataSize;
+  // A cell is the sequence number followed by the data.
+  size_t cellSize;
+  unsigned char *cells;
+} MpmcQueue;
+
+// Bounded wait-free queue for exactly one producer and one consumer thread.
+// Each side owns one position and keeps a cached copy of the other one, so
+// it only reads the shared line of the other side when the cached copy says
+// the queue is full or empty.
+typedef struct {
+  // Written by the producer.
+  _Alignas(ALGO_CACHE_LINE) atomic_uint_fast64_t tail;
+  uint64_t cachedHead;
+  // Written by the consumer.
+  _Alignas(ALGO_CACHE_LINE) atomic_uint_fast64_t head;
+  uint64_t cachedTail;
+  _Alignas(ALGO_CACHE_LINE) uint64_t mask;
+  size_t dataSize;
+  unsigned char *data;
+} SpscQueue;
+
+// Nodes per chunk of the node pool of a TreiberStack and the maximum amount
+// of chunks.
+#ifndef TSTACK_CHUNK_NODES
+#define TSTACK_CHUNK_NODES 4096
+#endif
+#ifndef TSTACK_MAX_CHUNKS
+#define TSTACK_MAX_CHUNKS 16384
+#endif
+// Slots of the elimination array of a TreiberStack.
+#ifndef TSTACK_ELIMINATION_SLOTS
+#define TSTACK_ELIMINATION_SLOTS 8
+#endif
+
+// Slot where a push that lost a race offers its node to a pop.
+typedef struct {
+  _Alignas(ALGO_CACHE_LINE) atomic_uint_fast64_t offer;
+} TreiberSlot;
+
+// Lock-free stack. The nodes come from a pool of chunks that is only freed
+// with the stack, popped nodes go to a free list, so a thread may still read
+// a node that was popped by another one. The heads hold a node index in the
+// low 32 bits and a tag that changes with every update in the high 32 bits,
+// which makes a compare and swap fail if the head was popped and pushed again
+// in between (the ABA problem).
+typedef struct {
+  _Alignas(ALGO_CACHE_LINE) atomic_uint_fast64_t head;
+  _Alignas(ALGO_CACHE_LINE) atomic_uint_fast64_t freeHead;
+  _Alignas(ALGO_CACHE_LINE) atomic_uint_fast64_t nodeCount;
+  TreiberSlot elimination[TSTACK_ELIMINATION_SLOTS];
+  _Alignas(ALGO_CACHE_LINE) _Atomic(unsigned char *) *chunks;
+  size_t dataSize;
+  // The data is stored in words, so concurrent readers never race with a
+  // writer on plain memory.
+  size_t words;
+  size_t nodeSize;
+  // Pushes and pops that lose a race try to meet in the elimination array.
+  int useElimination;
+} TreiberStack;
+
+// Size in bytes of one window of the segmented sieves. The default fits into
+// the L1 data cache of most cores, larger values trade cache hits for fewer
+// passes over the base primes.
+#ifndef PRIME_SEGMENT_BYTES
+#define PRIME_SEGMENT_BYTES 32768
+#endif
+
+// Amount of numbers covered by one window, only odd numbers are stored.
+#define PRIME_SEGMENT_SPAN ((uint64_t)PRIME_SEGMENT_BYTES * 16)
+
+// State of the odd-only segmented sieve. Bit k of the window starting at the
+// even number low stands for low + 2k + 1, a set bit marks a composite.
+typedef struct {
+  uint32_t *basePrimes;
+  uint64_t *nextOffset;
+  uint64_t baseCount;
+  uint64_t activeCount;
+  uint64_t low;
+  uint64_t limit;
+  // Set when the base primes belong to someone else, e.g. a parallel sieve.
+  int sharedBase;
+} PrimeSegmentSieve;
+
+// Streaming iterator over the primes in [start, stop). The window and the
+// base primes grow with the iterated numbers, so only O(sqrt(n)) memory is
+// held at any time.
+typedef struct {
+  PrimeSegmentSieve sieve;
+  uint64_t *words;
+  // Start of the current window, the amount of valid bits in it and the next
+  // bit to look at.
+  uint64_t windowLow;
+  uint64_t bits;
+  uint64_t position;
+  // The base primes go up to baseLimit.
+  uint64_t baseLimit;
+  // 2 is not part of the odd-only windows and gets returned separately.
+  int pendingTwo;
+} PrimeIterator;
+
+// Limbs of the smaller factor from which on the multiplication of two BigInt
+// switches from the schoolbook method to Karatsuba.
+#ifndef BIGINT_KARATSUBA_THRESHOLD
+#define BIGINT_KARATSUBA_THRESHOLD 32
+#endif
+
+// Limbs from which on the multiplication splits the factors into three parts
+// with Toom-3, it has to be at least 9.
+#ifndef BIGINT_TOOM3_THRESHOLD
+#define BIGINT_TOOM3_THRESHOLD 96
+#endif
+
+// Limbs of the smaller factor from which on the multiplication uses a number
+// theoretic transform.
+#ifndef BIGINT_NTT_THRESHOLD
+#define BIGINT_NTT_THRESHOLD 131072
+#endif
+
+// Non-negative integer of any size. The limbs hold the number in base 2^64,
+// least significant first, and size counts them without leading zero limbs,
+// so zero has the size 0.
+typedef struct {
+  uint64_t size;
+  uint64_t capacity;
+  uint64_t *limbs;
+} BigInt;
+
+// Tables of n! and 1/n! modulo a prime for n = 0, ..., limit, which answer
+// binomial coefficients modulo the prime with three lookups.
+typedef struct {
+  uint64_t prime;
+  uint64_t limit;
+  uint64_t *factorials;
+  uint64_t *inverseFactorials;
+} ModComb;
+
 typedef struct {
   uint64_t highestPosition;
   uint64_t size;
@@ -66,6 +367,111 @@ typedef struct {
   void (*datadeletefuncion)(void **data);
 } DynamicArray;
 
+// Rows of one tile of the incremental Game of life mode.
+#ifndef GOL_TILE_ROWS
+#define GOL_TILE_ROWS 64
+#endif
+
+// Game of life field with 64 cells per word, bit c % 64 of word c / 64 + 1
+// of a row holds column c. Every row is padded with one empty word on both
+// sides, so the neighbours of the outer words can be read without checks.
+// The next generation is computed into the second buffer and swapped in.
+typedef struct {
+  int rows;
+  int cols;
+  // Words per row including the padding.
+  size_t stride;
+  uint64_t *cells;
+  uint64_t *next;
+  // Cells that get updated, the outer columns stay dead like in gol_nextGen.
+  uint64_t *interiorMask;
+  // Incremental mode, NULL unless enabled. A tile is one word column of
+  // GOL_TILE_ROWS rows, only the active ones are recomputed.
+  uint8_t *activeTiles;
+  uint8_t *nextActive;
+  size_t tileRowCount;
+  size_t tileColCount;
+  uint64_t tilesTouched;
+  uint64_t tilesChanged;
+  uint64_t totalTilesTouched;
+  uint64_t trackedGenerations;
+} GolBitboard;
+
+// Counters of the incremental mode of a bitboard.
+typedef struct {
+  uint64_t tiles;
+  uint64_t touched;
+  uint64_t changed;
+  double averageTouched;
+} GolTileStats;
+
+// Game of life simulation on a bitboard with a persistent set of threads. The
+// rows are split into one band per thread, the calling thread of gol_run
+// steps the first one.
+typedef struct {
+  GolBitboard *board;
+  uint64_t generation;
+  uint32_t threads;
+  uint32_t started;
+  pthread_t *workers;
+  pthread_mutex_t lock;
+  pthread_cond_t wake;
+  pthread_barrier_t barrier;
+  // The current job, workers pick it up once jobId changes.
+  uint64_t jobId;
+  uint64_t jobGenerations;
+  int shutdown;
+} GolSimulation;
+
+// Node of the HashLife quadtree. A node of level k covers 2^k x 2^k cells,
+// the two leaves of level 0 are a dead and a living cell.
+typedef struct GolNode {
+  struct GolNode *nw;
+  struct GolNode *ne;
+  struct GolNode *sw;
+  struct GolNode *se;
+  // The middle half advanced by the step size of the universe, if known.
+  struct GolNode *result;
+  struct GolNode *hashNext;
+  uint64_t population;
+  uint32_t level;
+  uint32_t marked;
+} GolNode;
+
+// HashLife universe. Every node is canonical, two equal subtrees are the same
+// node, so the results memoized in the nodes are shared by every copy of a
+// pattern in space and time.
+typedef struct {
+  GolNode **table;
+  size_t tableSize;
+  size_t nodeCount;
+  size_t gcThreshold;
+  GolNode leaves[2];
+  GolNode *empty[64];
+  GolNode *root;
+  // Coordinates of the top left cell of the root.
+  int64_t originX;
+  int64_t originY;
+  uint64_t generation;
+  // The results are memoized for 2^stepLog generations.
+  uint32_t stepLog;
+} GolUniverse;
+
+// Growth factor of a ValueArray if none is given.
+#ifndef VALARR_GROWTH_FACTOR
+#define VALARR_GROWTH_FACTOR 2.0
+#endif
+
+// Dynamic array that stores the elements themselves instead of pointers to
+// them, in one contiguous buffer of capacity * dataSize bytes.
+typedef struct {
+  uint64_t size;
+  uint64_t capacity;
+  size_t dataSize;
+  double growthFactor;
+  uint8_t *data;
+} ValueArray;
+
 // Dynamic array functions:
 DynamicArray *dynarr_initialize(void *data, size_t dataSize,
                                 uint64_t initialSize,
@@ -79,6 +485,23 @@ int dynarr_delete(DynamicArray **list);
 void *dynarr_removeAt(DynamicArray *list, uint64_t position);
 int dynarr_addAt(DynamicArray *list, void *data, uint64_t position);
 
+// Value storage dynamic array functions:
+ValueArray *valarr_initialize(size_t dataSize, uint64_t initialCapacity,
+                              double growthFactor);
+void *valarr_at(ValueArray *array, uint64_t position);
+uint64_t valarr_size(ValueArray *array);
+uint64_t valarr_capacity(ValueArray *array);
+int valarr_reserve(ValueArray *array, uint64_t capacity);
+int valarr_shrinkToFit(ValueArray *array);
+int valarr_add(ValueArray *array, const void *data);
+int valarr_addN(ValueArray *array, const void *data, uint64_t count);
+int valarr_remove(ValueArray *array, void *out);
+int valarr_addAt(ValueArray *array, const void *data, uint64_t position);
+int valarr_removeAt(ValueArray *array, uint64_t position, void *out);
+int valarr_delete(ValueArray **array);
+void valarr_benchmark(uint64_t count);
+void typedarr_benchmark(uint64_t count);
+
 // Function prototypes:
 // Prime number computation:
 uint8_t *prime_so_prime(int);
@@ -89,6 +512,21 @@ int prime_prime(int);
 uint8_t *prime_boolarr(int n);
 uint64_t primes_calcPrimesNaive(uint64_t primesMax);
 uint8_t *prime_satkins(uint64_t limit);
+uint8_t *prime_me_primeSegmented(uint32_t n);
+uint64_t prime_countSegmented(uint64_t n);
+uint64_t prime_countParallel(uint64_t n, uint32_t threads);
+uint8_t *prime_me_primeParallel(uint32_t n, uint32_t threads);
+void prime_benchmarkParallel(uint64_t n, uint32_t maxThreads);
+int prime_iterInit(PrimeIterator *iter, uint64_t start, uint64_t stop);
+uint64_t prime_iterNext(PrimeIterator *iter);
+void prime_iterSkipTo(PrimeIterator *iter, uint64_t value);
+void prime_iterFree(PrimeIterator *iter);
+int prime_isPrime64(uint64_t n);
+void prime_isPrimeBatch(const uint64_t *candidates, uint8_t *results,
+                        size_t count);
+void prime_benchmarkPrimality(size_t count);
+uint64_t prime_countAtkin(uint64_t n);
+void prime_benchmarkEngines(uint64_t maxN);
 
 // Game of life methods.
 int **gol_generateEmptyField(int width, int height);
@@ -96,34 +534,93 @@ int **gol_nextGen(int **oldGen, int rows, int cols);
 void gol_printField(int **field, int width, int height);
 void gol_setField(int **field, int width, int height);
 void gol_nextGeni(int ***oldGen, int rows, int cols);
+GolBitboard *gol_bitboardCreate(int rows, int cols);
+GolBitboard *gol_bitboardFromField(int **field, int rows, int cols);
+void gol_bitboardCopyToField(GolBitboard *board, int **field);
+int **gol_bitboardToField(GolBitboard *board);
+int gol_bitboardGet(GolBitboard *board, int row, int col);
+void gol_bitboardSet(GolBitboard *board, int row, int col, int alive);
+void gol_bitboardStep(GolBitboard *board);
+uint64_t gol_bitboardPopulation(GolBitboard *board);
+void gol_bitboardDelete(GolBitboard *board);
+int gol_bitboardEnableTracking(GolBitboard *board);
+void gol_bitboardDisableTracking(GolBitboard *board);
+GolTileStats gol_bitboardTileStats(GolBitboard *board);
+GolSimulation *gol_simulationCreate(int rows, int cols, uint32_t threads);
+GolSimulation *gol_simulationFromField(int **field, int rows, int cols,
+                                       uint32_t threads);
+void gol_run(GolSimulation *sim, uint64_t generations);
+void gol_simulationDelete(GolSimulation *sim);
+GolUniverse *gol_hashlifeCreate(void);
+void gol_hashlifeDelete(GolUniverse *universe);
+void gol_hashlifeSetCell(GolUniverse *universe, int64_t x, int64_t y,
+                         int alive);
+int gol_hashlifeGetCell(GolUniverse *universe, int64_t x, int64_t y);
+uint64_t gol_hashlifePopulation(GolUniverse *universe);
+GolUniverse *gol_hashlifeFromField(int **field, int rows, int cols);
+void gol_hashlifeCopyToField(GolUniverse *universe, int **field, int rows,
+                             int cols);
+void gol_hashlifeCollect(GolUniverse *universe);
+void gol_hashlifeStep(GolUniverse *universe, uint32_t stepLog);
+void gol_hashlifeRun(GolUniverse *universe, uint64_t generations);
+int gol_hashlifeLoadRLE(GolUniverse *universe, const char *rle);
+char *gol_hashlifeToRLE(GolUniverse *universe);
+
+// Pool allocator:
+PoolAllocator *pool_create(size_t blockSize, size_t blocksPerSlab);
+void *pool_alloc(PoolAllocator *pool, size_t size);
+void pool_free(PoolAllocator *pool, void *block, size_t size);
+void pool_reset(PoolAllocator *pool);
+void pool_delete(PoolAllocator **pool);
+void pool_benchmark(uint64_t count);
 
 // Singly linked list:
 LinkedList *llist_createList(void *data, size_t dataSize);
+LinkedList *llist_createListWithAllocator(void *data, size_t dataSize,
+                                          Allocator *allocator);
 uint64_t llist_appendItem(LinkedList *list, void *data, uint64_t dataSize);
 int llist_printList(LinkedList *list, void (*outputData)(node *));
 node *llist_findItem(LinkedList *list, uint32_t id);
+// freefunc releases the data of a deleted node. Without an allocator it owns
+// the data block and is usually free. With an allocator the data is part of
+// the node, freefunc must not free it and only releases what it points to.
+// NULL lets the library free the data block in both cases.
 void llist_deleteItem(LinkedList *list, uint32_t id,
                       void (*freefunc)(void *data));
 void llist_deleteList(LinkedList *list, void (*freefunc)(void *data));
 int llist_merge(LinkedList *start, LinkedList *appendedList);
+int llist_resetArena(LinkedList *list);
+int llist_enableIndex(LinkedList *list);
+void llist_disableIndex(LinkedList *list);
+void llist_indexBenchmark(uint64_t count);
+int llist_sort(LinkedList *list,
+               int (*comparefunc)(const void *a, const void *b));
+void llist_sortBenchmark(uint64_t count);
 
 // Dynamic stack implementation:
 Stack *stack_create(void *data, size_t dataSize);
+Stack *stack_createWithAllocator(void *data, size_t dataSize,
+                                 Allocator *allocator);
+void stack_freeNode(Stack *node);
+int stack_resetArena(Stack **stack);
 uint32_t stack_push(Stack **stack, void *data, size_t dataSize);
 Stack *stack_pop(Stack **stack);
 uint32_t stack_empty(Stack **stack);
 Stack *stack_top(Stack *stack);
 
-// TODO:
-int llist_sort(LinkedList *list, void (*sortfunc)(void *data));
-
 // Doubly linked list:
 DLinkedList *dllist_initialization(void *data, size_t dataSize);
+DLinkedList *dllist_initializationWithAllocator(void *data, size_t dataSize,
+                                                Allocator *allocator);
+void dllist_freeNode(DLinkedList *list, DLNode *node);
+int dllist_resetArena(DLinkedList *list);
 uint32_t dllist_size(DLinkedList *list);
 int dllist_push(DLinkedList *list, void *data, size_t dataSize);
 DLNode *dllist_pop(DLinkedList *list);
 int dllist_isEmpty(DLinkedList *list);
 int dllist_merge(DLinkedList *list);
+int dllist_sort(DLinkedList *list,
+                int (*comparefunc)(const void *a, const void *b));
 
 // TODO:
 // TODO: implement id for the dllist elements.
@@ -131,17 +628,145 @@ DLNode *dllist_popStart(DLinkedList *list);
 DLNode *dllist_pushEnd(DLinkedList *list);
 int dllist_removeData(DLinkedList *list, void *data);
 int dllist_deleteList(DLinkedList *list, void (*deletefunc)(void *data));
-int dllist_sort(DLinkedList *list, void (*comparefunc)(DLNode *node));
 int dllist_print(DLinkedList *list, void (*printfunc)(void *data));
 
 // Queue:
 Queue *queue_initialize(void *data, size_t dataSize);
+Queue *queue_initializeWithAllocator(void *data, size_t dataSize,
+                                     Allocator *allocator);
+void queue_freeNode(Queue *queue, DLNode *node);
+int queue_resetArena(Queue *queue);
 int queue_enqueue(Queue *queue, void *data, size_t dataSize);
 DLNode *queue_dequeue(Queue *queue);
 
+// Lists and stack with inline data:
+InlineLinkedList *illist_create(size_t dataSize, Allocator *allocator);
+uint64_t illist_appendItem(InlineLinkedList *list, const void *data);
+InlineNode *illist_findItem(InlineLinkedList *list, uint64_t id);
+int illist_deleteItem(InlineLinkedList *list, uint64_t id);
+void illist_delete(InlineLinkedList **list);
+InlineDLinkedList *idllist_create(size_t dataSize, Allocator *allocator);
+int idllist_push(InlineDLinkedList *list, const void *data);
+int idllist_pop(InlineDLinkedList *list, void *out);
+uint64_t idllist_size(InlineDLinkedList *list);
+void idllist_delete(InlineDLinkedList **list);
+InlineStack *istack_create(size_t dataSize, Allocator *allocator);
+int istack_push(InlineStack *stack, const void *data);
+int istack_pop(InlineStack *stack, void *out);
+void *istack_top(InlineStack *stack);
+int istack_empty(InlineStack *stack);
+void istack_delete(InlineStack **stack);
+void inline_benchmark(uint64_t count);
+
+// Unrolled list:
+UnrolledList *ullist_create(size_t dataSize);
+uint64_t ullist_size(UnrolledList *list);
+void *ullist_at(UnrolledList *list, uint64_t position);
+int ullist_push(UnrolledList *list, const void *data);
+int ullist_pushFront(UnrolledList *list, const void *data);
+int ullist_pop(UnrolledList *list, void *out);
+int ullist_popBack(UnrolledList *list, void *out);
+int ullist_insertAt(UnrolledList *list, uint64_t position, const void *data);
+int ullist_removeAt(UnrolledList *list, uint64_t position, void *out);
+UnrolledIterator ullist_begin(UnrolledList *list);
+void *ullist_iterNext(UnrolledIterator *iterator);
+void *ullist_nextChunk(UnrolledIterator *iterator, uint64_t *count);
+void ullist_delete(UnrolledList **list);
+void ullist_benchmark(uint64_t count);
+
+// Bounded multi producer multi consumer queue:
+MpmcQueue *mpmc_create(uint64_t capacity, size_t dataSize);
+int mpmc_tryEnqueue(MpmcQueue *queue, const void *data);
+int mpmc_tryDequeue(MpmcQueue *queue, void *out);
+void mpmc_enqueue(MpmcQueue *queue, const void *data);
+void mpmc_dequeue(MpmcQueue *queue, void *out);
+uint64_t mpmc_enqueueN(MpmcQueue *queue, const void *data, uint64_t count);
+uint64_t mpmc_dequeueN(MpmcQueue *queue, void *out, uint64_t count);
+uint64_t mpmc_size(MpmcQueue *queue);
+void mpmc_delete(MpmcQueue **queue);
+void mpmc_benchmark(uint64_t items, uint32_t maxThreads);
+
+// Single producer single consumer queue:
+SpscQueue *spsc_create(uint64_t capacity, size_t dataSize);
+int spsc_tryEnqueue(SpscQueue *queue, const void *data);
+int spsc_tryDequeue(SpscQueue *queue, void *out);
+void spsc_enqueue(SpscQueue *queue, const void *data);
+void spsc_dequeue(SpscQueue *queue, void *out);
+uint64_t spsc_enqueueN(SpscQueue *queue, const void *data, uint64_t count);
+uint64_t spsc_dequeueN(SpscQueue *queue, void *out, uint64_t count);
+void *spsc_reserve(SpscQueue *queue, uint64_t *count);
+void spsc_publish(SpscQueue *queue, uint64_t count);
+void *spsc_peek(SpscQueue *queue, uint64_t *count);
+void spsc_consume(SpscQueue *queue, uint64_t count);
+uint64_t spsc_size(SpscQueue *queue);
+void spsc_delete(SpscQueue **queue);
+void spsc_benchmark(uint64_t items);
+
+// Lock-free stack:
+TreiberStack *tstack_create(size_t dataSize);
+int tstack_push(TreiberStack *stack, const void *data);
+int tstack_pop(TreiberStack *stack, void *out);
+int tstack_top(TreiberStack *stack, void *out);
+int tstack_empty(TreiberStack *stack);
+void tstack_delete(TreiberStack **stack);
+void tstack_benchmark(uint64_t operations, uint32_t maxThreads);
+
+// Ring buffer deque:
+RingDeque *deque_create(size_t dataSize, uint64_t initialCapacity);
+uint64_t deque_size(RingDeque *deque);
+int deque_reserve(RingDeque *deque, uint64_t capacity);
+void *deque_at(RingDeque *deque, uint64_t position);
+int deque_pushBack(RingDeque *deque, const void *data);
+int deque_pushFront(RingDeque *deque, const void *data);
+int deque_popFront(RingDeque *deque, void *out);
+int deque_popBack(RingDeque *deque, void *out);
+int deque_pushBackN(RingDeque *deque, const void *data, uint64_t count);
+uint64_t deque_popFrontN(RingDeque *deque, void *out, uint64_t count);
+uint64_t deque_copyOut(RingDeque *deque, uint64_t position, void *out,
+                       uint64_t count);
+void deque_clear(RingDeque *deque);
+void deque_delete(RingDeque **deque);
+void deque_benchmark(uint64_t count);
+
 // Various other algorithms:
 void xorswap(int *a, int *b);
 uint64_t factorial(uint64_t number);
 uint64_t factorialNR(uint64_t number);
 
+// Arbitrary precision integers:
+BigInt *bigint_create(uint64_t value);
+BigInt *bigint_copy(const BigInt *number);
+int bigint_set(BigInt *number, uint64_t value);
+int bigint_compare(const BigInt *a, const BigInt *b);
+uint64_t bigint_bitLength(const BigInt *number);
+int bigint_mulSmall(BigInt *number, uint64_t factor);
+int bigint_shiftLeft(BigInt *number, uint64_t bits);
+int bigint_add(BigInt *result, const BigInt *a, const BigInt *b);
+int bigint_sub(BigInt *result, const BigInt *a, const BigInt *b);
+int bigint_mul(BigInt *result, const BigInt *a, const BigInt *b);
+int bigint_divmod(BigInt *quotient, BigInt *remainder, const BigInt *a,
+                  const BigInt *b);
+BigInt *bigint_factorial(uint64_t n, uint32_t threads);
+BigInt *bigint_factorialNaive(uint64_t n);
+char *bigint_toString(const BigInt *number);
+void bigint_delete(BigInt **number);
+void bigint_benchmark(uint64_t maxN, uint32_t maxThreads);
+void bigint_mulBenchmark(uint64_t maxLimbs);
+
+// Modular factorials and binomial coefficients:
+// The tables cover n up to min(limit, prime - 1). A binomial coefficient
+// takes O(1) for n in the tables and O(log_p n) with Lucas' theorem if they
+// reach prime - 1. A query with n, or a base p digit of n, past the tables
+// returns UINT64_MAX, create the tables up to prime - 1 for arbitrary n.
+// modcomb_factorial multiplies the factors past the table one by one.
+ModComb *modcomb_create(uint64_t limit, uint64_t prime);
+uint64_t modcomb_factorial(ModComb *comb, uint64_t n);
+uint64_t modcomb_binomial(ModComb *comb, uint64_t n, uint64_t k);
+uint64_t modcomb_lucas(ModComb *comb, uint64_t n, uint64_t k);
+void modcomb_binomialBatch(ModComb *comb, const uint64_t *n,
+                           const uint64_t *k, uint64_t *results,
+                           size_t count);
+void modcomb_delete(ModComb **comb);
+void modcomb_benchmark(uint64_t limit, uint64_t queries);
+
 #endif
\ No newline at end of file
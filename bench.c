@@ -0,0 +1,732 @@
+// Benchmark driver for the algorithms library. Every case runs a few warm-up
+// rounds first and then a fixed amount of timed samples, whose median and
+// percentiles get reported together with hardware counters where the kernel
+// provides them. Setting up the input and freeing the output of a sample is
+// not part of its time.
+//
+// Usage: bench [--list] [--filter text] [--samples n] [--warmup n]
+//              [--scale factor] [--csv file] [--json file] [--no-counters]
+//              [--stats file]
+// --stats writes the container counters of a build with ALGO_INSTRUMENT.
+
+#include "algorithms.h"
+
+#include <errno.h>
+
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#endif
+
+// Hardware counters:
+
+#define BENCH_COUNTERS 4
+
+static const char *bench_counterNames[BENCH_COUNTERS] = {
+    "cycles", "instructions", "cache_misses", "branch_misses"};
+
+// File descriptors of the counters, -1 if a counter is not available.
+typedef struct {
+  int fds[BENCH_COUNTERS];
+  int available;
+} BenchCounters;
+
+// Opens the counters for the calling thread in user space. Containers and
+// kernels with perf_event_paranoid > 2 refuse them, then the benchmarks run
+// without counters.
+static void bench_countersOpen(BenchCounters *counters, int enabled) {
+  counters->available = 0;
+  for (int i = 0; i < BENCH_COUNTERS; i++) {
+    counters->fds[i] = -1;
+  }
+#ifdef __linux__
+  const uint64_t configs[BENCH_COUNTERS] = {
+      PERF_COUNT_HW_CPU_CYCLES, PERF_COUNT_HW_INSTRUCTIONS,
+      PERF_COUNT_HW_CACHE_MISSES, PERF_COUNT_HW_BRANCH_MISSES};
+  for (int i = 0; enabled && i < BENCH_COUNTERS; i++) {
+    struct perf_event_attr attr;
+    memset(&attr, 0, sizeof(attr));
+    attr.type = PERF_TYPE_HARDWARE;
+    attr.size = sizeof(attr);
+    attr.config = configs[i];
+    attr.disabled = 1;
+    attr.exclude_kernel = 1;
+    attr.exclude_hv = 1;
+    counters->fds[i] = (int)syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0);
+    if (counters->fds[i] >= 0) {
+      counters->available++;
+    } else if (i == 0) {
+      fprintf(stderr, "hardware counters unavailable: %s\n", strerror(errno));
+      return;
+    }
+  }
+#else
+  (void)enabled;
+#endif
+}
+
+static void bench_countersStart(BenchCounters *counters) {
+#ifdef __linux__
+  for (int i = 0; i < BENCH_COUNTERS; i++) {
+    if (counters->fds[i] >= 0) {
+      ioctl(counters->fds[i], PERF_EVENT_IOC_RESET, 0);
+      ioctl(counters->fds[i], PERF_EVENT_IOC_ENABLE, 0);
+    }
+  }
+#else
+  (void)counters;
+#endif
+}
+
+// Stops the counters and stores their values, UINT64_MAX for the missing
+// ones.
+static void bench_countersStop(BenchCounters *counters, uint64_t *values) {
+  for (int i = 0; i < BENCH_COUNTERS; i++) {
+    values[i] = UINT64_MAX;
+#ifdef __linux__
+    if (counters->fds[i] >= 0) {
+      uint64_t value = 0;
+      ioctl(counters->fds[i], PERF_EVENT_IOC_DISABLE, 0);
+      if (read(counters->fds[i], &value, sizeof(value)) == sizeof(value)) {
+        values[i] = value;
+      }
+    }
+#endif
+  }
+}
+
+static void bench_countersClose(BenchCounters *counters) {
+  for (int i = 0; i < BENCH_COUNTERS; i++) {
+    if (counters->fds[i] >= 0) {
+      close(counters->fds[i]);
+    }
+  }
+}
+
+// Cases:
+
+// Input and output of one sample. setup fills in the input, run produces the
+// output and teardown frees both. operations is the amount of elements or
+// calls the time per operation is reported for, it defaults to the size.
+typedef struct {
+  uint64_t size;
+  uint64_t operations;
+  void *input;
+  void *output;
+  uint64_t sink;
+} BenchState;
+
+typedef struct {
+  const char *group;
+  const char *name;
+  void (*setup)(BenchState *state);
+  void (*run)(BenchState *state);
+  void (*teardown)(BenchState *state);
+  // Input sizes of the case, terminated by 0.
+  uint64_t sizes[4];
+} BenchCase;
+
+static uint64_t bench_seed = 0x9E3779B97F4A7C15ULL;
+
+static uint64_t bench_random(void) {
+  bench_seed ^= bench_seed << 13;
+  bench_seed ^= bench_seed >> 7;
+  bench_seed ^= bench_seed << 17;
+  return bench_seed;
+}
+
+static void bench_noSetup(BenchState *state) { (void)state; }
+
+static void bench_freeOutput(BenchState *state) { free(state->output); }
+
+// Sieves:
+
+static void bench_soPrime(BenchState *state) {
+  state->output = prime_so_prime((int)state->size);
+}
+
+static void bench_mePrime(BenchState *state) {
+  state->output = prime_me_prime((uint32_t)state->size);
+}
+
+static void bench_mePrimeSegmented(BenchState *state) {
+  state->output = prime_me_primeSegmented((uint32_t)state->size);
+}
+
+static void bench_atkin(BenchState *state) {
+  state->output = prime_satkins(state->size);
+}
+
+static void bench_countSegmented(BenchState *state) {
+  state->sink = prime_countSegmented(state->size);
+}
+
+static void bench_countParallel(BenchState *state) {
+  state->sink = prime_countParallel(state->size, 0);
+}
+
+// Game of life:
+
+static void bench_freeField(int **field, int rows) {
+  if (field != NULL) {
+    for (int i = 0; i < rows; i++) {
+      free(field[i]);
+    }
+    free(field);
+  }
+}
+
+// A square field with about a third of the cells alive and a dead border.
+static void bench_golSetup(BenchState *state) {
+  int size = (int)state->size;
+  int **field = gol_generateEmptyField(size, size);
+  for (int i = 1; i < size - 1; i++) {
+    for (int j = 1; j < size - 1; j++) {
+      field[i][j] = bench_random() % 3 == 0;
+    }
+  }
+  state->input = field;
+}
+
+// gol_nextGen frees the old field, only the new one is left to free.
+static void bench_golNextGen(BenchState *state) {
+  state->output = gol_nextGen(state->input, (int)state->size, (int)state->size);
+  state->input = NULL;
+}
+
+static void bench_golTeardown(BenchState *state) {
+  bench_freeField(state->input, (int)state->size);
+  bench_freeField(state->output, (int)state->size);
+}
+
+static void bench_bitboardSetup(BenchState *state) {
+  bench_golSetup(state);
+  state->output =
+      gol_bitboardFromField(state->input, (int)state->size, (int)state->size);
+}
+
+static void bench_bitboardStep(BenchState *state) {
+  gol_bitboardStep(state->output);
+}
+
+static void bench_bitboardTeardown(BenchState *state) {
+  bench_freeField(state->input, (int)state->size);
+  gol_bitboardDelete(state->output);
+}
+
+// Dynamic array:
+
+static void bench_freeItem(void **data) { free(data); }
+
+static DynamicArray *bench_dynarrCreate(void) {
+  int *first = malloc(sizeof(int));
+  *first = 0;
+  DynamicArray *list = dynarr_initialize(first, sizeof(int), 16,
+                                         bench_freeItem);
+  free(first);
+  return list;
+}
+
+static void bench_dynarrFill(DynamicArray *list, uint64_t count) {
+  for (uint64_t i = 1; i < count; i++) {
+    int *item = malloc(sizeof(int));
+    *item = (int)i;
+    dynarr_add(list, item);
+  }
+}
+
+static void bench_dynarrSetup(BenchState *state) {
+  state->input = bench_dynarrCreate();
+}
+
+static void bench_dynarrFilledSetup(BenchState *state) {
+  state->input = bench_dynarrCreate();
+  bench_dynarrFill(state->input, state->size);
+}
+
+static void bench_dynarrAdd(BenchState *state) {
+  bench_dynarrFill(state->input, state->size);
+}
+
+static void bench_dynarrAt(BenchState *state) {
+  for (uint64_t i = 0; i < state->size; i++) {
+    state->sink += (uint64_t) * (int *)dynarr_at(state->input, i);
+  }
+}
+
+static void bench_dynarrRemove(BenchState *state) {
+  DynamicArray *list = state->input;
+  while (list->highestPosition > 0) {
+    free(dynarr_remove(list));
+  }
+}
+
+static void bench_dynarrTeardown(BenchState *state) {
+  dynarr_delete((DynamicArray **)&state->input);
+}
+
+// Singly linked list:
+
+static void bench_llistFill(LinkedList *list, uint64_t count) {
+  for (uint64_t i = 1; i < count; i++) {
+    llist_appendItem(list, &i, sizeof(i));
+  }
+}
+
+static void bench_llistSetup(BenchState *state) {
+  uint64_t first = 0;
+  state->input = llist_createList(&first, sizeof(first));
+}
+
+static void bench_llistFilledSetup(BenchState *state) {
+  bench_llistSetup(state);
+  bench_llistFill(state->input, state->size);
+}
+
+static void bench_llistAppend(BenchState *state) {
+  bench_llistFill(state->input, state->size);
+}
+
+// 1000 lookups of random ids, every one walks the list.
+static void bench_llistFind(BenchState *state) {
+  for (int i = 0; i < 1000; i++) {
+    node *item = llist_findItem(state->input,
+                                (uint32_t)(bench_random() % state->size));
+    state->sink += *(uint64_t *)item->data;
+  }
+}
+
+static void bench_llistDelete(BenchState *state) {
+  llist_deleteList(state->input, NULL);
+}
+
+static void bench_llistTeardown(BenchState *state) {
+  llist_deleteList(state->input, NULL);
+  free(state->input);
+}
+
+// Doubly linked list, stack and queue:
+
+static void bench_dllistPushPop(BenchState *state) {
+  uint64_t first = 0;
+  DLinkedList *list = dllist_initialization(&first, sizeof(first));
+  for (uint64_t i = 1; i < state->size; i++) {
+    dllist_push(list, &i, sizeof(i));
+  }
+  DLNode *item;
+  while ((item = dllist_pop(list)) != NULL) {
+    state->sink += *(uint64_t *)item->data;
+    dllist_freeNode(list, item);
+  }
+  free(list);
+}
+
+static void bench_stackPushPop(BenchState *state) {
+  uint64_t first = 0;
+  Stack *stack = stack_create(&first, sizeof(first));
+  for (uint64_t i = 1; i < state->size; i++) {
+    stack_push(&stack, &i, sizeof(i));
+  }
+  while (stack != NULL) {
+    Stack *item = stack_pop(&stack);
+    state->sink += *(uint64_t *)item->data;
+    stack_freeNode(item);
+  }
+}
+
+static void bench_queueCycle(BenchState *state) {
+  uint64_t first = 0;
+  Queue *queue = queue_initialize(&first, sizeof(first));
+  for (uint64_t i = 1; i < state->size; i++) {
+    queue_enqueue(queue, &i, sizeof(i));
+  }
+  DLNode *item;
+  while ((item = queue_dequeue(queue)) != NULL) {
+    state->sink += *(uint64_t *)item->data;
+    queue_freeNode(queue, item);
+  }
+  free(queue);
+}
+
+static void bench_dequeCycle(BenchState *state) {
+  RingDeque *deque = deque_create(sizeof(uint64_t), 0);
+  uint64_t value = 0;
+  for (uint64_t i = 0; i < state->size; i++) {
+    deque_pushBack(deque, &i);
+  }
+  while (deque_popFront(deque, &value)) {
+    state->sink += value;
+  }
+  deque_delete(&deque);
+}
+
+static void bench_valarrAdd(BenchState *state) {
+  ValueArray *array = valarr_initialize(sizeof(uint64_t), 0, 0);
+  for (uint64_t i = 0; i < state->size; i++) {
+    valarr_add(array, &i);
+  }
+  state->sink += valarr_size(array);
+  valarr_delete(&array);
+}
+
+// Factorials:
+
+// The word sized factorials take nanoseconds, so a sample is 100000 calls.
+static void bench_factorial(BenchState *state) {
+  state->operations = 100000;
+  for (int i = 0; i < 100000; i++) {
+    state->sink += factorial(state->size + (state->sink & 1));
+  }
+}
+
+static void bench_factorialNR(BenchState *state) {
+  state->operations = 100000;
+  for (int i = 0; i < 100000; i++) {
+    state->sink += factorialNR(state->size + (state->sink & 1));
+  }
+}
+
+static void bench_bigintFactorial(BenchState *state) {
+  state->output = bigint_factorial(state->size, 1);
+}
+
+static void bench_bigintFactorialNaive(BenchState *state) {
+  state->output = bigint_factorialNaive(state->size);
+}
+
+static void bench_bigintTeardown(BenchState *state) {
+  bigint_delete((BigInt **)&state->output);
+  bigint_delete((BigInt **)&state->input);
+}
+
+// Two random factors of size limbs, the input holds both.
+static void bench_bigintMulSetup(BenchState *state) {
+  BigInt *factors = calloc(2, sizeof(BigInt));
+  for (int i = 0; i < 2; i++) {
+    factors[i].limbs = malloc(state->size * sizeof(uint64_t));
+    factors[i].capacity = state->size;
+    factors[i].size = state->size;
+    for (uint64_t j = 0; j < state->size; j++) {
+      factors[i].limbs[j] = bench_random() | 1;
+    }
+  }
+  state->input = factors;
+  state->output = bigint_create(0);
+}
+
+static void bench_bigintMul(BenchState *state) {
+  BigInt *factors = state->input;
+  bigint_mul(state->output, &factors[0], &factors[1]);
+}
+
+static void bench_bigintMulTeardown(BenchState *state) {
+  BigInt *factors = state->input;
+  free(factors[0].limbs);
+  free(factors[1].limbs);
+  free(factors);
+  bigint_delete((BigInt **)&state->output);
+}
+
+static const BenchCase bench_cases[] = {
+    {"sieve", "prime_so_prime", bench_noSetup, bench_soPrime,
+     bench_freeOutput, {100000, 1000000, 10000000, 0}},
+    {"sieve", "prime_me_prime", bench_noSetup, bench_mePrime,
+     bench_freeOutput, {100000, 1000000, 10000000, 0}},
+    {"sieve", "prime_me_primeSegmented", bench_noSetup,
+     bench_mePrimeSegmented, bench_freeOutput, {100000, 1000000, 10000000, 0}},
+    {"sieve", "prime_satkins", bench_noSetup, bench_atkin, bench_freeOutput,
+     {100000, 1000000, 10000000, 0}},
+    {"sieve", "prime_countSegmented", bench_noSetup, bench_countSegmented,
+     bench_noSetup, {1000000, 10000000, 100000000, 0}},
+    {"sieve", "prime_countParallel", bench_noSetup, bench_countParallel,
+     bench_noSetup, {1000000, 10000000, 100000000, 0}},
+    {"gol", "gol_nextGen", bench_golSetup, bench_golNextGen,
+     bench_golTeardown, {64, 256, 1024, 0}},
+    {"gol", "gol_bitboardStep", bench_bitboardSetup, bench_bitboardStep,
+     bench_bitboardTeardown, {64, 256, 1024, 0}},
+    {"dynarr", "dynarr_add", bench_dynarrSetup, bench_dynarrAdd,
+     bench_dynarrTeardown, {1000, 100000, 1000000, 0}},
+    {"dynarr", "dynarr_at", bench_dynarrFilledSetup, bench_dynarrAt,
+     bench_dynarrTeardown, {1000, 100000, 1000000, 0}},
+    {"dynarr", "dynarr_remove", bench_dynarrFilledSetup, bench_dynarrRemove,
+     bench_dynarrTeardown, {1000, 100000, 1000000, 0}},
+    {"dynarr", "valarr_add", bench_noSetup, bench_valarrAdd, bench_noSetup,
+     {1000, 100000, 1000000, 0}},
+    {"llist", "llist_appendItem", bench_llistSetup, bench_llistAppend,
+     bench_llistTeardown, {1000, 100000, 1000000, 0}},
+    {"llist", "llist_findItem", bench_llistFilledSetup, bench_llistFind,
+     bench_llistTeardown, {1000, 10000, 100000, 0}},
+    {"llist", "llist_deleteList", bench_llistFilledSetup, bench_llistDelete,
+     bench_llistTeardown, {1000, 100000, 1000000, 0}},
+    {"dllist", "dllist_push_pop", bench_noSetup, bench_dllistPushPop,
+     bench_noSetup, {1000, 100000, 1000000, 0}},
+    {"stack", "stack_push_pop", bench_noSetup, bench_stackPushPop,
+     bench_noSetup, {1000, 100000, 1000000, 0}},
+    {"queue", "queue_enqueue_dequeue", bench_noSetup, bench_queueCycle,
+     bench_noSetup, {1000, 100000, 1000000, 0}},
+    {"queue", "deque_push_pop", bench_noSetup, bench_dequeCycle,
+     bench_noSetup, {1000, 100000, 1000000, 0}},
+    {"factorial", "factorial", bench_noSetup, bench_factorial, bench_noSetup,
+     {5, 10, 19, 0}},
+    {"factorial", "factorialNR", bench_noSetup, bench_factorialNR,
+     bench_noSetup, {5, 10, 19, 0}},
+    {"factorial", "bigint_factorial", bench_noSetup, bench_bigintFactorial,
+     bench_bigintTeardown, {1000, 10000, 100000, 0}},
+    {"factorial", "bigint_factorialNaive", bench_noSetup,
+     bench_bigintFactorialNaive, bench_bigintTeardown, {1000, 10000, 30000, 0}},
+    {"bigint", "bigint_mul", bench_bigintMulSetup, bench_bigintMul,
+     bench_bigintMulTeardown, {100, 1000, 10000, 0}},
+};
+
+// Measurement and reports:
+
+typedef struct {
+  uint32_t warmup;
+  uint32_t samples;
+  double scale;
+  const char *filter;
+  FILE *csv;
+  FILE *json;
+  FILE *stats;
+  int counters;
+} BenchOptions;
+
+static int bench_compareDouble(const void *a, const void *b) {
+  double x = *(const double *)a;
+  double y = *(const double *)b;
+  return (x > y) - (x < y);
+}
+
+static int bench_compareUint64(const void *a, const void *b) {
+  uint64_t x = *(const uint64_t *)a;
+  uint64_t y = *(const uint64_t *)b;
+  return (x > y) - (x < y);
+}
+
+// Nearest rank percentile of the sorted values.
+static double bench_percentile(const double *sorted, uint32_t count,
+                               double percent) {
+  uint32_t rank = (uint32_t)ceil(percent / 100.0 * count);
+  return sorted[(rank == 0) ? 0 : rank - 1];
+}
+
+static double bench_seconds(void) {
+  struct timespec now;
+  clock_gettime(CLOCK_MONOTONIC, &now);
+  return (double)now.tv_sec + (double)now.tv_nsec * 1e-9;
+}
+
+// Runs one sample of the case and returns its time in seconds.
+static double bench_sample(const BenchCase *benchCase, uint64_t size,
+                           BenchCounters *counters, uint64_t *values,
+                           uint64_t *operations) {
+  BenchState state = {size, size, NULL, NULL, 0};
+  benchCase->setup(&state);
+  bench_countersStart(counters);
+  double start = bench_seconds();
+  benchCase->run(&state);
+  double time = bench_seconds() - start;
+  bench_countersStop(counters, values);
+  benchCase->teardown(&state);
+  // Keeps the compiler from dropping computations that only feed the sink.
+  bench_seed ^= state.sink & 1;
+  *operations = state.operations;
+  return time;
+}
+
+static void bench_runCase(const BenchCase *benchCase, uint64_t size,
+                          const BenchOptions *options,
+                          BenchCounters *counters, int *firstJson) {
+  uint64_t operations = size;
+  for (uint32_t i = 0; i < options->warmup; i++) {
+    uint64_t values[BENCH_COUNTERS];
+    bench_sample(benchCase, size, counters, values, &operations);
+  }
+  double *times = malloc(options->samples * sizeof(double));
+  uint64_t *values = malloc(options->samples * BENCH_COUNTERS *
+                            sizeof(uint64_t));
+  for (uint32_t i = 0; i < options->samples; i++) {
+    times[i] = bench_sample(benchCase, size, counters,
+                            values + i * BENCH_COUNTERS, &operations);
+  }
+  qsort(times, options->samples, sizeof(double), bench_compareDouble);
+  double median = bench_percentile(times, options->samples, 50);
+  double p90 = bench_percentile(times, options->samples, 90);
+  double p99 = bench_percentile(times, options->samples, 99);
+  double perOperation = median * 1e9 / (double)operations;
+
+  // Median of every counter over the samples.
+  uint64_t medians[BENCH_COUNTERS];
+  uint64_t *column = malloc(options->samples * sizeof(uint64_t));
+  for (int c = 0; c < BENCH_COUNTERS; c++) {
+    for (uint32_t i = 0; i < options->samples; i++) {
+      column[i] = values[i * BENCH_COUNTERS + c];
+    }
+    qsort(column, options->samples, sizeof(uint64_t), bench_compareUint64);
+    medians[c] = column[(options->samples - 1) / 2];
+  }
+
+  printf("%-10s %-26s %-10llu %-12.4f %-12.4f %-12.4f %-10.2f",
+         benchCase->group, benchCase->name, (unsigned long long)size,
+         median * 1e3, p90 * 1e3, p99 * 1e3, perOperation);
+  if (medians[0] != UINT64_MAX && medians[1] != UINT64_MAX) {
+    printf(" %-6.2f", (double)medians[1] / (double)medians[0]);
+  }
+  printf("\n");
+
+  if (options->csv != NULL) {
+    fprintf(options->csv, "%s,%s,%llu,%u,%.0f,%.0f,%.0f,%.0f,%.0f,%.3f",
+            benchCase->group, benchCase->name, (unsigned long long)size,
+            options->samples, times[0] * 1e9, median * 1e9, p90 * 1e9,
+            p99 * 1e9, times[options->samples - 1] * 1e9, perOperation);
+    for (int c = 0; c < BENCH_COUNTERS; c++) {
+      if (medians[c] != UINT64_MAX) {
+        fprintf(options->csv, ",%llu", (unsigned long long)medians[c]);
+      } else {
+        fprintf(options->csv, ",");
+      }
+    }
+    fprintf(options->csv, "\n");
+  }
+  if (options->json != NULL) {
+    fprintf(options->json,
+            "%s\n    {\"group\": \"%s\", \"name\": \"%s\", \"size\": %llu, "
+            "\"samples\": %u, \"min_ns\": %.0f, \"median_ns\": %.0f, "
+            "\"p90_ns\": %.0f, \"p99_ns\": %.0f, \"max_ns\": %.0f, "
+            "\"ns_per_op\": %.3f",
+            *firstJson ? "" : ",", benchCase->group, benchCase->name,
+            (unsigned long long)size, options->samples, times[0] * 1e9,
+            median * 1e9, p90 * 1e9, p99 * 1e9,
+            times[options->samples - 1] * 1e9, perOperation);
+    for (int c = 0; c < BENCH_COUNTERS; c++) {
+      if (medians[c] != UINT64_MAX) {
+        fprintf(options->json, ", \"%s\": %llu", bench_counterNames[c],
+                (unsigned long long)medians[c]);
+      } else {
+        fprintf(options->json, ", \"%s\": null", bench_counterNames[c]);
+      }
+    }
+    fprintf(options->json, "}");
+    *firstJson = 0;
+  }
+  free(column);
+  free(values);
+  free(times);
+}
+
+static void bench_usage(const char *program) {
+  fprintf(stderr,
+          "usage: %s [--list] [--filter text] [--samples n] [--warmup n]\n"
+          "          [--scale factor] [--csv file] [--json file] "
+          "[--no-counters]\n"
+          "          [--stats file]\n",
+          program);
+}
+
+int main(int argc, char **argv) {
+  BenchOptions options = {2, 11, 1.0, NULL, NULL, NULL, NULL, 1};
+  size_t caseCount = sizeof(bench_cases) / sizeof(bench_cases[0]);
+  for (int i = 1; i < argc; i++) {
+    const char *argument = argv[i];
+    const char *value = (i + 1 < argc) ? argv[i + 1] : NULL;
+    if (strcmp(argument, "--list") == 0) {
+      for (size_t c = 0; c < caseCount; c++) {
+        printf("%s/%s\n", bench_cases[c].group, bench_cases[c].name);
+      }
+      return 0;
+    } else if (strcmp(argument, "--no-counters") == 0) {
+      options.counters = 0;
+    } else if (value == NULL) {
+      bench_usage(argv[0]);
+      return 1;
+    } else if (strcmp(argument, "--filter") == 0) {
+      options.filter = value;
+    } else if (strcmp(argument, "--samples") == 0) {
+      options.samples = (uint32_t)strtoul(value, NULL, 10);
+    } else if (strcmp(argument, "--warmup") == 0) {
+      options.warmup = (uint32_t)strtoul(value, NULL, 10);
+    } else if (strcmp(argument, "--scale") == 0) {
+      options.scale = strtod(value, NULL);
+    } else if (strcmp(argument, "--csv") == 0) {
+      options.csv = fopen(value, "w");
+    } else if (strcmp(argument, "--json") == 0) {
+      options.json = fopen(value, "w");
+    } else if (strcmp(argument, "--stats") == 0) {
+      options.stats = fopen(value, "w");
+    } else {
+      bench_usage(argv[0]);
+      return 1;
+    }
+    if ((strcmp(argument, "--csv") == 0 && options.csv == NULL) ||
+        (strcmp(argument, "--json") == 0 && options.json == NULL) ||
+        (strcmp(argument, "--stats") == 0 && options.stats == NULL)) {
+      fprintf(stderr, "can not open %s: %s\n", value, strerror(errno));
+      return 1;
+    }
+    i++;
+  }
+  if (options.samples == 0 || options.scale <= 0) {
+    bench_usage(argv[0]);
+    return 1;
+  }
+
+  BenchCounters counters;
+  bench_countersOpen(&counters, options.counters);
+  if (options.csv != NULL) {
+    fprintf(options.csv, "group,name,size,samples,min_ns,median_ns,p90_ns,"
+                         "p99_ns,max_ns,ns_per_op");
+    for (int c = 0; c < BENCH_COUNTERS; c++) {
+      fprintf(options.csv, ",%s", bench_counterNames[c]);
+    }
+    fprintf(options.csv, "\n");
+  }
+  if (options.json != NULL) {
+    fprintf(options.json, "{\n  \"samples\": %u,\n  \"warmup\": %u,\n  "
+                          "\"counters\": %s,\n  \"results\": [",
+            options.samples, options.warmup,
+            counters.available ? "true" : "false");
+  }
+  printf("%-10s %-26s %-10s %-12s %-12s %-12s %-10s %s\n", "group", "case",
+         "size", "median ms", "p90 ms", "p99 ms", "ns/op",
+         counters.available ? "ipc" : "");
+
+  int firstJson = 1;
+  for (size_t c = 0; c < caseCount; c++) {
+    const BenchCase *benchCase = &bench_cases[c];
+    if (options.filter != NULL && strstr(benchCase->group, options.filter) ==
+                                      NULL &&
+        strstr(benchCase->name, options.filter) == NULL) {
+      continue;
+    }
+    uint64_t previous = 0;
+    for (int s = 0; s < 4 && benchCase->sizes[s] != 0; s++) {
+      uint64_t size = (uint64_t)((double)benchCase->sizes[s] * options.scale);
+      // The word sized factorials overflow past 20!.
+      if (strcmp(benchCase->group, "factorial") == 0 &&
+          benchCase->sizes[s] < 20) {
+        size = benchCase->sizes[s];
+      }
+      size = (size < 4) ? 4 : size;
+      // Small scales can map several sizes to the same one.
+      if (size != previous) {
+        bench_runCase(benchCase, size, &options, &counters, &firstJson);
+        previous = size;
+      }
+    }
+  }
+
+  if (options.json != NULL) {
+    fprintf(options.json, "\n  ]\n}\n");
+    fclose(options.json);
+  }
+  if (options.csv != NULL) {
+    fclose(options.csv);
+  }
+  if (options.stats != NULL) {
+    algo_instrDump(options.stats);
+    fclose(options.stats);
+  }
+  bench_countersClose(&counters);
+  return 0;
+}
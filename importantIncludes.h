@@ -3,11 +3,25 @@
 #ifndef IMPINCLUDES_H
 #define IMPINCLUDES_H
 
+// Needed for sysconf and the other POSIX interfaces used by the threaded
+// algorithms.
+#ifndef _GNU_SOURCE
+#define _GNU_SOURCE
+#endif
+
 #include <math.h>
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stddef.h>
 #include <stdint.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 #include <time.h>
+#include <unistd.h>
+
+#ifdef __AVX2__
+#include <immintrin.h>
+#endif
 
 #endif
\ No newline at end of file
@@ -0,0 +1,129 @@
+// Enables the header to only be included
+#pragma once
+
+// Include guard for compilers not knowing the pragma directive.
+#ifndef INSTRUMENTATION_H
+#define INSTRUMENTATION_H
+
+#include "importantIncludes.h"
+
+// Counters for the hot paths of the containers. They are compiled out unless
+// ALGO_INSTRUMENT is defined, until then every macro below is a no-op and the
+// containers run unchanged. With it, the macros update relaxed atomic
+// counters, which keeps them correct with several threads but costs an atomic
+// add per event.
+
+// Containers the counters are kept for. A queue is a doubly linked list and is
+// counted as one.
+typedef enum {
+  ALGO_INSTR_DYNARR,
+  ALGO_INSTR_LLIST,
+  ALGO_INSTR_DLLIST,
+  ALGO_INSTR_STACK,
+  ALGO_INSTR_CONTAINERS
+} AlgoInstrContainer;
+
+// Counters of one container type, summed over all of its instances.
+// allocations and frees count the blocks a container owns: the struct and the
+// pointer array of a dynamic array, where every resize allocates a new array
+// and frees the old one, and the nodes of the lists and stacks with their
+// data. The elements of a dynamic array belong to the caller and are not
+// counted, not even the copy dynarr_initialize makes of the first one, so the
+// two counters are equal once every container was deleted. copies counts the
+// elements moved to open or close a gap, and traversals the walks along the
+// nodes of a list together with the nodes they passed.
+typedef struct {
+  _Atomic uint64_t allocations;
+  _Atomic uint64_t allocatedBytes;
+  _Atomic uint64_t frees;
+  _Atomic uint64_t resizes;
+  _Atomic uint64_t resizedBytes;
+  _Atomic uint64_t copies;
+  _Atomic uint64_t copiedBytes;
+  _Atomic uint64_t traversals;
+  _Atomic uint64_t traversedNodes;
+  _Atomic uint64_t longestTraversal;
+} AlgoInstrStats;
+
+// Time spent between the begin and the end of a named scope. Every scope is a
+// static variable at its site that registers itself on its first end.
+typedef struct AlgoInstrScope {
+  const char *name;
+  _Atomic uint64_t calls;
+  _Atomic uint64_t nanoseconds;
+  _Atomic int registered;
+  struct AlgoInstrScope *next;
+} AlgoInstrScope;
+
+// Clears every counter and scope.
+void algo_instrReset(void);
+// Writes the counters and scopes as JSON, {"enabled": false} if the library
+// was built without instrumentation.
+int algo_instrDump(FILE *out);
+
+#ifdef ALGO_INSTRUMENT
+
+extern AlgoInstrStats algo_instrStats[ALGO_INSTR_CONTAINERS];
+
+uint64_t algo_instrNow(void);
+void algo_instrScopeEnd(AlgoInstrScope *scope, uint64_t start);
+
+#define ALGO_INSTR_ADD(counter, value)                                         \
+  atomic_fetch_add_explicit(&(counter), (uint64_t)(value),                     \
+                            memory_order_relaxed)
+
+static inline void algo_instrTraversal(AlgoInstrStats *stats, uint64_t nodes) {
+  ALGO_INSTR_ADD(stats->traversals, 1);
+  ALGO_INSTR_ADD(stats->traversedNodes, nodes);
+  uint64_t longest =
+      atomic_load_explicit(&stats->longestTraversal, memory_order_relaxed);
+  while (nodes > longest &&
+         !atomic_compare_exchange_weak_explicit(&stats->longestTraversal,
+                                                &longest, nodes,
+                                                memory_order_relaxed,
+                                                memory_order_relaxed)) {
+  }
+}
+
+#define ALGO_INSTR_ALLOC(container, count, bytes)                              \
+  do {                                                                         \
+    ALGO_INSTR_ADD(algo_instrStats[container].allocations, count);             \
+    ALGO_INSTR_ADD(algo_instrStats[container].allocatedBytes, bytes);          \
+  } while (0)
+#define ALGO_INSTR_FREE(container, count)                                      \
+  ALGO_INSTR_ADD(algo_instrStats[container].frees, count)
+#define ALGO_INSTR_RESIZE(container, bytes)                                    \
+  do {                                                                         \
+    ALGO_INSTR_ADD(algo_instrStats[container].resizes, 1);                     \
+    ALGO_INSTR_ADD(algo_instrStats[container].resizedBytes, bytes);            \
+  } while (0)
+#define ALGO_INSTR_COPY(container, count, bytes)                               \
+  do {                                                                         \
+    ALGO_INSTR_ADD(algo_instrStats[container].copies, count);                  \
+    ALGO_INSTR_ADD(algo_instrStats[container].copiedBytes, bytes);             \
+  } while (0)
+#define ALGO_INSTR_TRAVERSAL(container, nodes)                                 \
+  algo_instrTraversal(&algo_instrStats[container], nodes)
+
+// Times the code up to the ALGO_INSTR_SCOPE_END of the same name in the same
+// block. Returns in between leave the call uncounted.
+#define ALGO_INSTR_SCOPE_BEGIN(name)                                           \
+  static AlgoInstrScope algo_instrScope_##name = {#name, 0, 0, 0, NULL};       \
+  uint64_t algo_instrStart_##name = algo_instrNow()
+#define ALGO_INSTR_SCOPE_END(name)                                             \
+  algo_instrScopeEnd(&algo_instrScope_##name, algo_instrStart_##name)
+
+#else
+
+#define ALGO_INSTR_ALLOC(container, count, bytes) ((void)(container))
+#define ALGO_INSTR_FREE(container, count) ((void)(container))
+#define ALGO_INSTR_RESIZE(container, bytes) ((void)(container))
+#define ALGO_INSTR_COPY(container, count, bytes) ((void)(container))
+#define ALGO_INSTR_TRAVERSAL(container, nodes)                                 \
+  ((void)(container), (void)(nodes))
+#define ALGO_INSTR_SCOPE_BEGIN(name) ((void)0)
+#define ALGO_INSTR_SCOPE_END(name) ((void)0)
+
+#endif
+
+#endif
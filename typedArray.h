@@ -0,0 +1,157 @@
+// Enables the header to only be included
+#pragma once
+
+// Include guard for compilers not knowing the pragma directive.
+#ifndef TYPEDARRAY_H
+#define TYPEDARRAY_H
+
+#include "importantIncludes.h"
+
+// Generates a dynamic array for one element type. The functions have the same
+// surface as the dynarr_* functions, but the elements are stored by value and
+// their size is known at compile time, so the accesses can be inlined and the
+// loops over the data can be vectorized.
+// Example: DYNARR_DECLARE(Int32Array, int32arr, int32_t) declares the type
+// Int32Array and the functions int32arr_initialize, int32arr_at, ...
+#define DYNARR_DECLARE(NAME, PREFIX, TYPE)                                     \
+  typedef struct {                                                             \
+    uint64_t size;                                                             \
+    uint64_t capacity;                                                         \
+    TYPE *data;                                                                \
+  } NAME;                                                                      \
+                                                                               \
+  /* Sets the capacity of the array, it never drops below the size. */        \
+  static inline int PREFIX##_resize(NAME *list, uint64_t capacity) {          \
+    if (list == NULL) {                                                        \
+      return 0;                                                                \
+    } else {                                                                   \
+      if (capacity < list->size) {                                             \
+        capacity = list->size;                                                 \
+      }                                                                        \
+      if (capacity == 0) {                                                     \
+        free(list->data);                                                      \
+        list->data = NULL;                                                     \
+        list->capacity = 0;                                                    \
+        return 1;                                                              \
+      }                                                                        \
+      TYPE *data = realloc(list->data, capacity * sizeof(TYPE));               \
+      if (data == NULL) {                                                      \
+        return 0;                                                              \
+      }                                                                        \
+      list->data = data;                                                       \
+      list->capacity = capacity;                                               \
+      return 1;                                                                \
+    }                                                                          \
+  }                                                                            \
+                                                                               \
+  static inline NAME *PREFIX##_initialize(uint64_t initialSize) {              \
+    NAME *list = malloc(sizeof(NAME));                                         \
+    if (list == NULL) {                                                        \
+      return NULL;                                                             \
+    }                                                                          \
+    list->size = 0;                                                            \
+    list->capacity = 0;                                                        \
+    list->data = NULL;                                                         \
+    if (initialSize && !PREFIX##_resize(list, initialSize)) {                  \
+      free(list);                                                              \
+      return NULL;                                                             \
+    }                                                                          \
+    return list;                                                               \
+  }                                                                            \
+                                                                               \
+  static inline uint64_t PREFIX##_size(const NAME *list) {                     \
+    return (list == NULL) ? 0 : list->size;                                    \
+  }                                                                            \
+                                                                               \
+  /* Returns a pointer to the element, or NULL if the position is invalid. */  \
+  static inline TYPE *PREFIX##_at(NAME *list, uint64_t position) {             \
+    if (list == NULL || position >= list->size) {                              \
+      return NULL;                                                             \
+    } else {                                                                   \
+      return list->data + position;                                            \
+    }                                                                          \
+  }                                                                            \
+                                                                               \
+  /* Returns the element without checking the position. */                     \
+  static inline TYPE PREFIX##_get(const NAME *list, uint64_t position) {       \
+    return list->data[position];                                               \
+  }                                                                            \
+                                                                               \
+  /* Doubles the capacity if there is no room for another element. */         \
+  static inline int PREFIX##_reserveOne(NAME *list) {                          \
+    if (list->size < list->capacity) {                                         \
+      return 1;                                                                \
+    } else {                                                                   \
+      return PREFIX##_resize(list, list->capacity ? list->capacity * 2 : 16);  \
+    }                                                                          \
+  }                                                                            \
+                                                                               \
+  static inline int PREFIX##_add(NAME *list, TYPE data) {                      \
+    if (list == NULL || !PREFIX##_reserveOne(list)) {                          \
+      return 0;                                                                \
+    } else {                                                                   \
+      list->data[list->size++] = data;                                         \
+      return 1;                                                                \
+    }                                                                          \
+  }                                                                            \
+                                                                               \
+  /* Removes the last element and writes it to out, if out is not NULL. */     \
+  static inline int PREFIX##_remove(NAME *list, TYPE *out) {                   \
+    if (list == NULL || list->size == 0) {                                     \
+      return 0;                                                                \
+    } else {                                                                   \
+      list->size--;                                                            \
+      if (out != NULL) {                                                       \
+        *out = list->data[list->size];                                         \
+      }                                                                        \
+      return 1;                                                                \
+    }                                                                          \
+  }                                                                            \
+                                                                               \
+  static inline int PREFIX##_addAt(NAME *list, TYPE data,                      \
+                                   uint64_t position) {                        \
+    if (list == NULL || position > list->size ||                               \
+        !PREFIX##_reserveOne(list)) {                                          \
+      return 0;                                                                \
+    } else {                                                                   \
+      memmove(list->data + position + 1, list->data + position,                \
+              (list->size - position) * sizeof(TYPE));                         \
+      list->data[position] = data;                                             \
+      list->size++;                                                            \
+      return 1;                                                                \
+    }                                                                          \
+  }                                                                            \
+                                                                               \
+  static inline int PREFIX##_removeAt(NAME *list, uint64_t position,           \
+                                      TYPE *out) {                             \
+    if (list == NULL || position >= list->size) {                              \
+      return 0;                                                                \
+    } else {                                                                   \
+      if (out != NULL) {                                                       \
+        *out = list->data[position];                                           \
+      }                                                                        \
+      memmove(list->data + position, list->data + position + 1,                \
+              (list->size - position - 1) * sizeof(TYPE));                     \
+      list->size--;                                                            \
+      return 1;                                                                \
+    }                                                                          \
+  }                                                                            \
+                                                                               \
+  static inline int PREFIX##_delete(NAME **list) {                             \
+    if (list == NULL || *list == NULL) {                                       \
+      return 0;                                                                \
+    } else {                                                                   \
+      free((*list)->data);                                                     \
+      free(*list);                                                             \
+      *list = NULL;                                                            \
+      return 1;                                                                \
+    }                                                                          \
+  }
+
+// The specializations for the common plain data types.
+DYNARR_DECLARE(Int32Array, int32arr, int32_t)
+DYNARR_DECLARE(Int64Array, int64arr, int64_t)
+DYNARR_DECLARE(Uint64Array, uint64arr, uint64_t)
+DYNARR_DECLARE(DoubleArray, doublearr, double)
+
+#endif